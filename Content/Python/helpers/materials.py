@@ -0,0 +1,31 @@
+# Copyright (c) 2022 Ryan DowlingSoka - MIT License
+
+"""Helpers for scripting material edits."""
+
+from contextlib import contextmanager
+from typing import Iterator
+import unreal
+
+
+@contextmanager
+def material_edit_batch(description: str = "Edit Material Parameters", wait_for_compilation: bool = False) -> Iterator[None]:
+    """Groups every RedMaterialParameterBlueprintLibrary edit made inside the with block into one undo transaction,
+    and recompiles each affected material once when the block exits, even if it raised."""
+    unreal.RedMaterialParameterBlueprintLibrary.begin_material_edit_batch(unreal.Text(description))
+    try:
+        yield
+    finally:
+        unreal.RedMaterialParameterBlueprintLibrary.end_material_edit_batch(wait_for_compilation)
+
+
+@contextmanager
+def material_parameter_preview(description: str = "Edit Material Parameters") -> Iterator[None]:
+    """Previews every RedMaterialParameterBlueprintLibrary edit made inside the with block without transactions or
+    recompiles, then commits them as one undoable edit. The original values are restored if the block raised."""
+    unreal.RedMaterialParameterBlueprintLibrary.begin_material_parameter_preview(unreal.Text(description))
+    try:
+        yield
+    except BaseException:
+        unreal.RedMaterialParameterBlueprintLibrary.end_material_parameter_preview(False)
+        raise
+    unreal.RedMaterialParameterBlueprintLibrary.end_material_parameter_preview(True)
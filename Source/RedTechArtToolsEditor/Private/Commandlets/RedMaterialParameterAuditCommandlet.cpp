@@ -0,0 +1,82 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Commandlets/RedMaterialParameterAuditCommandlet.h"
+
+#include "RedMaterialParameterAudit.h"
+
+URedMaterialParameterAuditCommandlet::URedMaterialParameterAuditCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 URedMaterialParameterAuditCommandlet::Main(const FString& Params)
+{
+	FString OutputFile;
+	if (!FParse::Value(*Params, TEXT("Output="), OutputFile))
+	{
+		UE_LOG(LogRedMaterialParameterAudit, Error,
+		       TEXT("Missing -Output=<File>. Usage: -run=RedMaterialParameterAudit -Output=<File.csv|File.json> "
+			       "[-Paths=/Game/A+/Game/B] [-Shard=<Index> -NumShards=<Count>] [-BatchSize=64]"));
+		return 1;
+	}
+
+	FRedMaterialParameterAuditOptions Options;
+	FString PathsString;
+	if (FParse::Value(*Params, TEXT("Paths="), PathsString))
+	{
+		TArray<FString> Paths;
+		PathsString.ParseIntoArray(Paths, TEXT("+"));
+		for (const FString& Path : Paths)
+		{
+			Options.PackagePaths.Add(FName(Path));
+		}
+	}
+	FParse::Value(*Params, TEXT("Shard="), Options.Shard);
+	FParse::Value(*Params, TEXT("NumShards="), Options.NumShards);
+	FParse::Value(*Params, TEXT("BatchSize="), Options.BatchSize);
+
+	if (Options.NumShards < 1 || Options.Shard < 0 || Options.Shard >= Options.NumShards)
+	{
+		UE_LOG(LogRedMaterialParameterAudit, Error, TEXT("Shard %d is out of range for %d shards."),
+		       Options.Shard, Options.NumShards);
+		return 1;
+	}
+
+	const TUniquePtr<FRedMaterialParameterAuditWriter> Writer = FRedMaterialParameterAuditWriter::Create(
+		OutputFile, FRedMaterialParameterAuditWriter::GetFormatFromFilename(OutputFile));
+	if (!Writer)
+	{
+		return 1;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumFailed = FRedMaterialParameterAudit::Run(Options, *Writer);
+	Writer->Close();
+
+	UE_LOG(LogRedMaterialParameterAudit, Display, TEXT("Wrote %d parameters to '%s' in %.1fs, %d assets failed to load."),
+	       Writer->GetNumWrittenRows(), *OutputFile, FPlatformTime::Seconds() - StartTime, NumFailed);
+	return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,447 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Commandlets/RedMaterialToolsCommandlet.h"
+
+#include "RedMaterialInstanceHierarchy.h"
+#include "RedMaterialParameterAudit.h"
+#include "RedMaterialParameterBlueprintLibrary.h"
+#include "Algo/Find.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialFunction.h"
+#include "UObject/StrongObjectPtr.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRedMaterialTools, Log, All);
+
+namespace RedMaterialToolsCommandlet
+{
+	const TCHAR* Usage = TEXT("Usage: -run=RedMaterialTools <list|export|rename|regroup|prune|audit> "
+		"[-Paths=/Game/A+/Game/B | -Packages=/Game/A/M_A+/Game/B/M_B] [-BatchSize=64] [-DryRun], "
+		"see URedMaterialToolsCommandlet for the options of each subcommand.");
+
+	struct FContext
+	{
+		const FString& Params;
+		TArray<FName> PackagePaths;
+		TArray<FSoftObjectPath> Assets;
+		int32 BatchSize = 64;
+		bool bDryRun = false;
+	};
+
+	TArray<FString> ParseList(const FString& Params, const TCHAR* Key)
+	{
+		TArray<FString> Values;
+		FString Value;
+		if (FParse::Value(*Params, Key, Value))
+		{
+			Value.ParseIntoArray(Values, TEXT("+"));
+		}
+		return Values;
+	}
+
+	/** Materials and material functions in -Packages, or in -Paths if there are no packages. */
+	TArray<FSoftObjectPath> FindAssets(const FString& Params, const TArray<FName>& PackagePaths)
+	{
+		TArray<FSoftObjectPath> Assets;
+		const TArray<FString> Packages = ParseList(Params, TEXT("Packages="));
+		if (Packages.Num() == 0)
+		{
+			FRedMaterialParameterAuditOptions Options;
+			Options.PackagePaths = PackagePaths;
+			for (const FAssetData& AssetData : FRedMaterialParameterAudit::FindAssets(Options))
+			{
+				Assets.Add(AssetData.GetSoftObjectPath());
+			}
+			return Assets;
+		}
+
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		TArray<FAssetData> PackageAssets;
+		for (const FString& Package : Packages)
+		{
+			PackageAssets.Reset();
+			AssetRegistry.GetAssetsByPackageName(FName(Package), PackageAssets);
+			if (PackageAssets.Num() == 0)
+			{
+				UE_LOG(LogRedMaterialTools, Warning, TEXT("No assets found in package '%s'."), *Package);
+			}
+			for (const FAssetData& AssetData : PackageAssets)
+			{
+				const UClass* AssetClass = AssetData.GetClass();
+				if (AssetClass != nullptr
+					&& (AssetClass->IsChildOf<UMaterial>() || AssetClass->IsChildOf<UMaterialFunction>()))
+				{
+					Assets.Add(AssetData.GetSoftObjectPath());
+				}
+			}
+		}
+		return Assets;
+	}
+
+	int32 RunList(const FContext& Context)
+	{
+		FString Type;
+		FString Group;
+		const bool bFilterType = FParse::Value(*Context.Params, TEXT("Type="), Type);
+		const bool bFilterGroup = FParse::Value(*Context.Params, TEXT("Group="), Group);
+
+		int32 NumParameters = 0;
+		TArray<FRedMaterialParameterAuditRow> Rows;
+		FRedMaterialInstanceHierarchy::LoadInBatches(Context.Assets, Context.BatchSize, true,
+		                                             [&](TConstArrayView<UObject*> Objects)
+		{
+			Rows.Reset();
+			FRedMaterialParameterAudit::GatherRows(Objects, Rows);
+			for (const FRedMaterialParameterAuditRow& Row : Rows)
+			{
+				if ((bFilterType && Row.TypeName != FName(Type)) || (bFilterGroup && Row.Group != FName(Group)))
+				{
+					continue;
+				}
+				UE_LOG(LogRedMaterialTools, Display, TEXT("%s\t%s\t%s\t%s"), *Row.Asset, *Row.ParameterName.ToString(),
+				       *Row.TypeName.ToString(), *Row.Group.ToString());
+				++NumParameters;
+			}
+		});
+		UE_LOG(LogRedMaterialTools, Display, TEXT("Listed %d parameters in %d assets."), NumParameters,
+		       Context.Assets.Num());
+		return 0;
+	}
+
+	int32 RunExport(const FContext& Context)
+	{
+		FString OutputFile;
+		if (!FParse::Value(*Context.Params, TEXT("Output="), OutputFile))
+		{
+			UE_LOG(LogRedMaterialTools, Error, TEXT("export needs -Output=<File>."));
+			return 1;
+		}
+
+		const TUniquePtr<FRedMaterialParameterAuditWriter> Writer = FRedMaterialParameterAuditWriter::Create(
+			OutputFile, FRedMaterialParameterAuditWriter::GetFormatFromFilename(OutputFile));
+		if (!Writer)
+		{
+			return 1;
+		}
+
+		TArray<FRedMaterialParameterAuditRow> Rows;
+		FRedMaterialInstanceHierarchy::LoadInBatches(Context.Assets, Context.BatchSize, true,
+		                                             [&](TConstArrayView<UObject*> Objects)
+		{
+			Rows.Reset();
+			FRedMaterialParameterAudit::GatherRows(Objects, Rows);
+			Writer->Write(Rows);
+		});
+		Writer->Close();
+
+		UE_LOG(LogRedMaterialTools, Display, TEXT("Wrote %d parameters to '%s'."), Writer->GetNumWrittenRows(),
+		       *OutputFile);
+		return 0;
+	}
+
+	int32 RunRename(const FContext& Context)
+	{
+		FString OldNameString;
+		FString NewNameString;
+		if (!FParse::Value(*Context.Params, TEXT("Parameter="), OldNameString)
+			|| !FParse::Value(*Context.Params, TEXT("NewName="), NewNameString))
+		{
+			UE_LOG(LogRedMaterialTools, Error, TEXT("rename needs -Parameter=<Name> and -NewName=<Name>."));
+			return 1;
+		}
+		const FName OldName(OldNameString);
+		const FName NewName(NewNameString);
+
+		// Validate everything before changing anything, a rename that would merge two parameters is an error.
+		TArray<FSoftObjectPath> Targets;
+		int32 NumFailed = 0;
+		FRedMaterialInstanceHierarchy::LoadInBatches(Context.Assets, Context.BatchSize, true,
+		                                             [&](TConstArrayView<UObject*> Objects)
+		{
+			for (UObject* Object : Objects)
+			{
+				bool bHasOldName = false;
+				bool bHasNewName = false;
+				URedMaterialParameterBlueprintLibrary::ForEachMaterialParameterExpression(
+					Object, true, [&](UMaterialExpression* Expression)
+					{
+						// Only the asset's own parameters are renamed, the functions it calls are their own targets.
+						bHasOldName |= Expression->GetParameterName() == OldName
+							&& URedMaterialParameterBlueprintLibrary::GetMaterialExpression_OwningObject(Expression)
+							== Object;
+						bHasNewName |= Expression->GetParameterName() == NewName;
+					});
+				if (bHasOldName && bHasNewName)
+				{
+					UE_LOG(LogRedMaterialTools, Error, TEXT("'%s' already has a parameter named '%s'."),
+					       *Object->GetPathName(), *NewName.ToString());
+					++NumFailed;
+				}
+				else if (bHasOldName)
+				{
+					Targets.Add(FSoftObjectPath(Object));
+				}
+			}
+		});
+		if (NumFailed > 0 || Context.bDryRun)
+		{
+			for (const FSoftObjectPath& Target : Targets)
+			{
+				UE_LOG(LogRedMaterialTools, Display, TEXT("Would rename '%s' in '%s'."), *OldName.ToString(),
+				       *Target.ToString());
+			}
+			return NumFailed > 0 ? 1 : 0;
+		}
+
+		// The rename loads and releases instances on its own, so the targets are loaded one at a time and kept alive
+		// while their expressions are renamed. One call renames every node of the asset with the old name.
+		int32 NumInstances = 0;
+		for (const FSoftObjectPath& Target : Targets)
+		{
+			const TStrongObjectPtr<UObject> Object(Target.TryLoad());
+			UMaterialExpression* FirstExpression = nullptr;
+			URedMaterialParameterBlueprintLibrary::ForEachMaterialParameterExpression(
+				Object.Get(), false, [&](UMaterialExpression* Expression)
+				{
+					if (FirstExpression == nullptr && Expression->GetParameterName() == OldName)
+					{
+						FirstExpression = Expression;
+					}
+				});
+			if (FirstExpression == nullptr)
+			{
+				UE_LOG(LogRedMaterialTools, Error, TEXT("Could not load '%s'."), *Target.ToString());
+				++NumFailed;
+				continue;
+			}
+
+			FRedMaterialParameterInfo Info(FirstExpression);
+			int32 NumFailedSaves = 0;
+			NumInstances += URedMaterialParameterBlueprintLibrary::RenameMaterialParameterInHierarchy(
+				Info, NewName, NumFailedSaves, true);
+			NumFailed += NumFailedSaves;
+			// The rename refuses, and logs why, if it would merge parameters in materials using the function.
+			if (FirstExpression->GetParameterName() != NewName)
+			{
+				++NumFailed;
+			}
+		}
+		UE_LOG(LogRedMaterialTools, Display, TEXT("Renamed '%s' to '%s' in %d assets and %d instances, %d failures."),
+		       *OldName.ToString(), *NewName.ToString(), Targets.Num(), NumInstances, NumFailed);
+		return NumFailed > 0 ? 1 : 0;
+	}
+
+	int32 RunRegroup(const FContext& Context)
+	{
+		FString NewGroupString;
+		FString OldGroupString;
+		FString ParameterString;
+		const bool bFilterGroup = FParse::Value(*Context.Params, TEXT("Group="), OldGroupString);
+		const bool bFilterParameter = FParse::Value(*Context.Params, TEXT("Parameter="), ParameterString);
+		if (!FParse::Value(*Context.Params, TEXT("NewGroup="), NewGroupString) || !(bFilterGroup || bFilterParameter))
+		{
+			UE_LOG(LogRedMaterialTools, Error, TEXT("regroup needs -NewGroup=<Group> and -Group=<Group> and/or "
+				       "-Parameter=<Name>."));
+			return 1;
+		}
+		const FName NewGroup(NewGroupString);
+		const FName OldGroup(OldGroupString);
+		const FName Parameter(ParameterString);
+
+		int32 NumParameters = 0;
+		int32 NumFailed = 0;
+		TArray<FRedMaterialParameterEdit> Edits;
+		TArray<UPackage*> TouchedPackages;
+		FRedMaterialInstanceHierarchy::LoadInBatches(Context.Assets, Context.BatchSize, true,
+		                                             [&](TConstArrayView<UObject*> Objects)
+		{
+			Edits.Reset();
+			for (UObject* Object : Objects)
+			{
+				const int32 NumEdits = Edits.Num();
+				URedMaterialParameterBlueprintLibrary::ForEachMaterialParameterExpression(
+					Object, false, [&](UMaterialExpression* Expression)
+					{
+						FRedMaterialParameterInfo Info(Expression);
+						if ((bFilterParameter && Info.ParameterName != Parameter)
+							|| (bFilterGroup && Info.ParameterInfo.Group != OldGroup)
+							|| Info.ParameterInfo.Group == NewGroup)
+						{
+							return;
+						}
+						FRedMaterialParameterEdit& Edit = Edits.Emplace_GetRef(Info);
+						Edit.bSetGroup = true;
+						Edit.Group = NewGroup;
+					});
+				if (Edits.Num() > NumEdits)
+				{
+					TouchedPackages.Add(Object->GetPackage());
+				}
+			}
+
+			NumParameters += Edits.Num();
+			if (!Context.bDryRun)
+			{
+				URedMaterialParameterBlueprintLibrary::ApplyMaterialParameterEdits(Edits);
+				NumFailed += FRedMaterialInstanceHierarchy::SavePackages(TouchedPackages);
+			}
+			TouchedPackages.Reset();
+		});
+		UE_LOG(LogRedMaterialTools, Display, TEXT("%s %d parameters to group '%s'."),
+		       Context.bDryRun ? TEXT("Would move") : TEXT("Moved"), NumParameters, *NewGroup.ToString());
+		return NumFailed > 0 ? 1 : 0;
+	}
+
+	int32 RunPrune(const FContext& Context)
+	{
+		// Every prune loads and releases the instances below its material on its own, so materials are loaded one at
+		// a time.
+		FRedMaterialOverridePruneReport Total;
+		for (const FSoftObjectPath& Asset : Context.Assets)
+		{
+			const TStrongObjectPtr<UMaterialInterface> Material(Cast<UMaterialInterface>(Asset.TryLoad()));
+			if (!Material.IsValid())
+			{
+				continue;
+			}
+			const FRedMaterialOverridePruneReport Report =
+				URedMaterialParameterBlueprintLibrary::PruneRedundantMaterialInstanceOverrides(
+					Material.Get(), Context.bDryRun, !Context.bDryRun);
+			Total.NumInstancesVisited += Report.NumInstancesVisited;
+			Total.NumInstancesChanged += Report.NumInstancesChanged;
+			Total.NumOverridesRemoved += Report.NumOverridesRemoved;
+			Total.NumStaticOverridesRemoved += Report.NumStaticOverridesRemoved;
+			Total.NumShaderPermutationsRemoved += Report.NumShaderPermutationsRemoved;
+			Total.PackageBytesSaved += Report.PackageBytesSaved;
+			Total.NumFailedSaves += Report.NumFailedSaves;
+		}
+		UE_LOG(LogRedMaterialTools, Display,
+		       TEXT("%s %d overrides (%d static) from %d of %d instances, %d fewer shader permutations, %lld bytes saved."),
+		       Context.bDryRun ? TEXT("Would remove") : TEXT("Removed"), Total.NumOverridesRemoved,
+		       Total.NumStaticOverridesRemoved, Total.NumInstancesChanged, Total.NumInstancesVisited,
+		       Total.NumShaderPermutationsRemoved, Total.PackageBytesSaved);
+		if (Total.NumFailedSaves > 0)
+		{
+			UE_LOG(LogRedMaterialTools, Error, TEXT("%d changed instances failed to save."), Total.NumFailedSaves);
+			return 1;
+		}
+		return 0;
+	}
+
+	int32 RunAudit(const FContext& Context)
+	{
+		// Context.Assets already honours -Packages, falling back to -Paths.
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		TArray<FAssetData> Assets;
+		for (const FSoftObjectPath& Asset : Context.Assets)
+		{
+			const FAssetData AssetData = AssetRegistry.GetAssetByObjectPath(Asset);
+			if (AssetData.IsValid())
+			{
+				Assets.Add(AssetData);
+			}
+		}
+		const FRedMaterialParameterConsistencyReport Report = FRedMaterialParameterConsistency::Check(Assets, true);
+		for (const FRedMaterialParameterConflict& Conflict : Report.Conflicts)
+		{
+			UE_LOG(LogRedMaterialTools, Error, TEXT("'%s' is declared %d different ways (%s)."),
+			       *Conflict.ParameterName.ToString(), Conflict.Signatures.Num(),
+			       *FString::JoinBy(Conflict.ConflictingFields, TEXT(", "), [](const FName Field)
+			       {
+				       return Field.ToString();
+			       }));
+		}
+
+		FString OutputFile;
+		if (FParse::Value(*Context.Params, TEXT("Output="), OutputFile)
+			&& !FRedMaterialParameterConsistency::ExportReport(Report, OutputFile))
+		{
+			return 1;
+		}
+
+		UE_LOG(LogRedMaterialTools, Display, TEXT("Checked %d parameters in %d assets, found %d conflicts."),
+		       Report.NumParametersChecked, Report.NumAssetsChecked, Report.Conflicts.Num());
+		return Report.Conflicts.Num() > 0 ? 1 : 0;
+	}
+}
+
+URedMaterialToolsCommandlet::URedMaterialToolsCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 URedMaterialToolsCommandlet::Main(const FString& Params)
+{
+	using namespace RedMaterialToolsCommandlet;
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	ParseCommandLine(*Params, Tokens, Switches);
+	if (Tokens.Num() == 0)
+	{
+		UE_LOG(LogRedMaterialTools, Error, TEXT("Missing subcommand. %s"), Usage);
+		return 1;
+	}
+
+	using FSubcommand = int32(*)(const FContext&);
+	static const TPair<const TCHAR*, FSubcommand> Subcommands[] = {
+		{TEXT("list"), &RunList},
+		{TEXT("export"), &RunExport},
+		{TEXT("rename"), &RunRename},
+		{TEXT("regroup"), &RunRegroup},
+		{TEXT("prune"), &RunPrune},
+		{TEXT("audit"), &RunAudit},
+	};
+	const TPair<const TCHAR*, FSubcommand>* Subcommand = Algo::FindByPredicate(
+		Subcommands, [&Tokens](const TPair<const TCHAR*, FSubcommand>& Pair)
+		{
+			return Tokens[0].Equals(Pair.Key, ESearchCase::IgnoreCase);
+		});
+	if (Subcommand == nullptr)
+	{
+		UE_LOG(LogRedMaterialTools, Error, TEXT("Unknown subcommand '%s'. %s"), *Tokens[0], Usage);
+		return 1;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	FContext Context{Params};
+	for (const FString& Path : ParseList(Params, TEXT("Paths=")))
+	{
+		Context.PackagePaths.Add(FName(Path));
+	}
+	Context.Assets = FindAssets(Params, Context.PackagePaths);
+	FParse::Value(*Params, TEXT("BatchSize="), Context.BatchSize);
+	Context.BatchSize = FMath::Max(Context.BatchSize, 1);
+	Context.bDryRun = FParse::Param(*Params, TEXT("DryRun"));
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 Result = Subcommand->Value(Context);
+	UE_LOG(LogRedMaterialTools, Display, TEXT("%s finished in %.1fs with %s."), *Tokens[0],
+	       FPlatformTime::Seconds() - StartTime, Result == 0 ? TEXT("success") : TEXT("errors"));
+	return Result;
+}
@@ -22,14 +22,14 @@
 
 #include "Customization/RedEditorIconPathCustomization.h"
 #include "DetailWidgetRow.h"
+#include "RedEditorIconIndex.h"
 #include "RedEditorIconWidget.h"
-#include "RedDeveloperSettings.h"
 #include "SSearchableComboBox.h"
-#include "Algo/Transform.h"
-#include "Brushes/SlateImageBrush.h"
-#include "HAL/FileManager.h"
+#include "Styling/SlateStyleRegistry.h"
+#include "Widgets/SOverlay.h"
 #include "Widgets/SToolTip.h"
 #include "Widgets/Images/SImage.h"
+#include "Widgets/Input/SSegmentedControl.h"
 
 #define LOCTEXT_NAMESPACE "RedEditorIconCustomization"
 
@@ -49,85 +49,164 @@ void FRedEditorIconPathCustomization::CustomizeHeader(TSharedRef<IPropertyHandle
 	{
 		check(StructData);
 		FRedEditorIconPath* CurrentValue = static_cast<FRedEditorIconPath*>(StructData);
-		const FString CurrentValuePath = CurrentValue->Path;
-		const FString ItemName = FPaths::GetCleanFilename(*CurrentValuePath);
-		const auto CurrentSelectionText = SNew(STextBlock)
-			.Text_Lambda([=]() { return FText::FromString(FPaths::GetCleanFilename(CurrentValue->Path)); });
+		// Both combo boxes show the current selection, and a widget can only have one parent, so make one each.
+		const auto MakeCurrentSelectionText = [=]()
+		{
+			return SNew(STextBlock)
+				.Text_Lambda([=]()
+				{
+					if (CurrentValue->Source == ERedEditorIconSource::SlateStyle)
+					{
+						return FText::FromName(CurrentValue->StyleName);
+					}
+					return FText::FromString(FPaths::GetCleanFilename(CurrentValue->Path));
+				});
+		};
+		const auto MakeCurrentSelectionToolTip = [=]()
+		{
+			return SNew(SToolTip).Text_Lambda([=]()
+			{
+				if (CurrentValue->Source == ERedEditorIconSource::SlateStyle)
+				{
+					return FText::Format(LOCTEXT("StyleIconToolTip", "{0}: {1}"),
+					                     FText::FromName(CurrentValue->StyleSetName),
+					                     FText::FromName(CurrentValue->StyleName));
+				}
+				return FText::FromString(FPaths::ConvertRelativePathToFull(CurrentValue->Path));
+			});
+		};
+
 		HeaderRow.NameContent()[StructPropertyHandle->CreatePropertyNameWidget()]
 			.ValueContent()
+			.MinDesiredWidth(300.0f)
 			[
-				SNew(SSearchableComboBox)
-			.OptionsSource(GetIconOptionsPointer())
-			.OnGenerateWidget(this, &FRedEditorIconPathCustomization::HandleGenerateWidget)
-			.OnSelectionChanged_Lambda([=](TSharedPtr<FString> NewChoice, ESelectInfo::Type SelectType)
-				                         {
-					                         if (NewChoice.IsValid())
-					                         {
-					                         	const FScopedTransaction Transaction(LOCTEXT("SetEditorIcon", "Set Editor Icon Path"));
-						                         StructPropertyHandle.Get().NotifyPreChange();
-						                         CurrentValue->Path = *NewChoice;
-						                         StructPropertyHandle.Get().NotifyPostChange(
-							                         EPropertyChangeType::ValueSet);
-					                         }
-				                         })
-			.ToolTip(SNew(SToolTip).Text_Lambda([=]()
-				                         {
-					                         return FText::FromString(
-						                         FPaths::ConvertRelativePathToFull(CurrentValue->Path));
-				                         }))
-			.Content()
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				  .AutoWidth()
+				  .Padding(0.0f, 0.0f, 4.0f, 0.0f)
+				  .VAlign(EVerticalAlignment::VAlign_Center)
+				[
+					SNew(SSegmentedControl<ERedEditorIconSource>)
+					.Value_Lambda([=]() { return CurrentValue->Source; })
+					.OnValueChanged_Lambda([=](const ERedEditorIconSource NewSource)
+					{
+						const FScopedTransaction Transaction(LOCTEXT("SetEditorIconSource", "Set Editor Icon Source"));
+						StructPropertyHandle.Get().NotifyPreChange();
+						CurrentValue->Source = NewSource;
+						StructPropertyHandle.Get().NotifyPostChange(EPropertyChangeType::ValueSet);
+					})
+					+ SSegmentedControl<ERedEditorIconSource>::Slot(ERedEditorIconSource::File)
+					.Text(LOCTEXT("IconSource_File", "File"))
+					.ToolTip(LOCTEXT("IconSource_FileToolTip", "Load an icon file from the engine content directories."))
+					+ SSegmentedControl<ERedEditorIconSource>::Slot(ERedEditorIconSource::SlateStyle)
+					.Text(LOCTEXT("IconSource_Style", "Style"))
+					.ToolTip(LOCTEXT("IconSource_StyleToolTip",
+					                 "Use a brush already registered in a Slate style set, like the editor's app style."))
+				]
+				+ SHorizontalBox::Slot()
+				.FillWidth(1.0f)
 				[
-					CurrentSelectionText
+					SNew(SOverlay)
+					+ SOverlay::Slot()
+					[
+						SAssignNew(CachedSearchableComboBox, SSearchableComboBox)
+						.Visibility_Lambda([=]()
+						{
+							return CurrentValue->Source == ERedEditorIconSource::File
+								       ? EVisibility::Visible
+								       : EVisibility::Collapsed;
+						})
+						.OptionsSource(FRedEditorIconIndex::Get().GetOptionsSource())
+						.OnGenerateWidget(this, &FRedEditorIconPathCustomization::HandleGenerateWidget)
+						.OnSelectionChanged_Lambda([=](TSharedPtr<FString> NewChoice, ESelectInfo::Type SelectType)
+						{
+							if (NewChoice.IsValid())
+							{
+								const FScopedTransaction Transaction(LOCTEXT("SetEditorIcon", "Set Editor Icon Path"));
+								StructPropertyHandle.Get().NotifyPreChange();
+								CurrentValue->Source = ERedEditorIconSource::File;
+								CurrentValue->Path = *NewChoice;
+								StructPropertyHandle.Get().NotifyPostChange(EPropertyChangeType::ValueSet);
+							}
+						})
+						.ToolTip(MakeCurrentSelectionToolTip())
+						.Content()
+						[
+							MakeCurrentSelectionText()
+						]
+					]
+					+ SOverlay::Slot()
+					[
+						SAssignNew(CachedStyleComboBox, SSearchableComboBox)
+						.Visibility_Lambda([=]()
+						{
+							return CurrentValue->Source == ERedEditorIconSource::SlateStyle
+								       ? EVisibility::Visible
+								       : EVisibility::Collapsed;
+						})
+						.OptionsSource(FRedEditorIconIndex::Get().GetStyleOptionsSource())
+						.OnComboBoxOpening_Lambda([this]()
+						{
+							// Plugins can register style sets at any time, pick them up when the list is opened.
+							FRedEditorIconIndex::Get().GetStyleOptionsSource();
+							CachedStyleComboBox->RefreshOptions();
+						})
+						.OnGenerateWidget(this, &FRedEditorIconPathCustomization::HandleGenerateStyleWidget)
+						.OnSelectionChanged_Lambda([=](TSharedPtr<FString> NewChoice, ESelectInfo::Type SelectType)
+						{
+							if (!NewChoice.IsValid())
+							{
+								return;
+							}
+							if (const TSharedPtr<const FRedEditorStyleIconEntry> Entry =
+								FRedEditorIconIndex::Get().FindStyleEntry(*NewChoice))
+							{
+								const FScopedTransaction Transaction(LOCTEXT("SetEditorIconStyle", "Set Editor Icon Style"));
+								StructPropertyHandle.Get().NotifyPreChange();
+								CurrentValue->Source = ERedEditorIconSource::SlateStyle;
+								CurrentValue->StyleSetName = Entry->StyleSetName;
+								CurrentValue->StyleName = Entry->StyleName;
+								StructPropertyHandle.Get().NotifyPostChange(EPropertyChangeType::ValueSet);
+							}
+						})
+						.ToolTip(MakeCurrentSelectionToolTip())
+						.Content()
+						[
+							MakeCurrentSelectionText()
+						]
+					]
 				]
 			];
+
+		// Icons added or removed on disk are patched into the shared index, refresh the list when that happens.
+		FRedEditorIconIndex::Get().OnIndexChanged().AddSP(CachedSearchableComboBox.ToSharedRef(),
+		                                                  &SSearchableComboBox::RefreshOptions);
 	}
 }
 
 TSharedRef<SWidget> FRedEditorIconPathCustomization::HandleGenerateWidget(TSharedPtr<FString> InItem)
 {
-	const int EngineIndex = InItem->Find(TEXT("/Engine/"));
-	const int EditorIndex = InItem->Find(TEXT("/Editor/"));
-	int RightChopIndex = 0;
-	if (EngineIndex >= 0 || EditorIndex >= 0)
-	{
-		RightChopIndex = FMath::Max(EngineIndex + 7, EditorIndex + 7);
-	}
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedEditorIconPathCustomization::HandleGenerateWidget);
 
-	static FVector2D IconSize = FVector2D(24, 24);
-	const FString AbsolutePath = FPaths::ConvertRelativePathToFull(*InItem);
-	const FString ItemName = FPaths::GetCleanFilename(*InItem);
-	const FString Category = InItem->RightChop(RightChopIndex).LeftChop(ItemName.Len() + 1).
-	                                 Replace(TEXT("/Content/"),TEXT("/")).
-	                                 Replace(TEXT("/Slate/"),TEXT("/")).
-	                                 Replace(TEXT("/Plugins/"),TEXT("/")).
-	                                 Replace(TEXT("/Experimental/"),TEXT("/")).RightChop(1);
+	const TSharedPtr<const FRedEditorIconEntry> Entry = InItem.IsValid()
+		                                                    ? FRedEditorIconIndex::Get().FindEntry(*InItem)
+		                                                    : nullptr;
 
-	if (!InItem->IsEmpty() && IFileManager::Get().FileExists(*AbsolutePath))
+	if (Entry.IsValid() && Entry->bExists)
 	{
-		TUniquePtr<FSlateBrush>& Item = GeneratedBrushes.FindOrAdd(*InItem);
-		if (!Item.IsValid())
+		const TSharedPtr<FSlateBrush> Brush = FRedEditorIconIndex::Get().GetPreviewBrush(*Entry);
+		if (!Brush.IsValid())
 		{
-			if (const FString Ext = FPaths::GetExtension(*InItem); Ext == "svg")
-			{
-				Item.Reset(new FSlateVectorImageBrush(*InItem, IconSize));
-			}
-			else if (Ext == "png")
-			{
-				Item.Reset(new FSlateDynamicImageBrush(FName(**InItem), IconSize));
-			}
-			else
-			{
-				return SNew(STextBlock).Text(FText::FromString(FString("Path is not a .png or .svg file.")));
-			}
+			return SNew(STextBlock).Text(FText::FromString(FString("Path is not a .png or .svg file.")));
 		}
 		return SNew(SHorizontalBox)
-			.ToolTip(SNew(SToolTip).Text(FText::FromString(*AbsolutePath)))
+			.ToolTipText(FText::FromString(Entry->AbsolutePath))
 			+ SHorizontalBox::Slot()
 			  .AutoWidth()
 			  .VAlign(EVerticalAlignment::VAlign_Center)
 			[
 				SNew(SImage)
-				.Image(Item.Get())
+				.Image_Lambda([Brush]() { return Brush.Get(); })
 			]
 			+ SHorizontalBox::Slot()
 			  .AutoWidth()
@@ -135,7 +214,7 @@ TSharedRef<SWidget> FRedEditorIconPathCustomization::HandleGenerateWidget(TShare
 			  .VAlign(EVerticalAlignment::VAlign_Center)
 			[
 				SNew(STextBlock)
-			.Text(FText::FromString(ItemName))
+			.Text(Entry->DisplayName)
 			.MinDesiredWidth(200.0f)
 			]
 			+ SHorizontalBox::Slot()
@@ -145,7 +224,7 @@ TSharedRef<SWidget> FRedEditorIconPathCustomization::HandleGenerateWidget(TShare
 			  .HAlign(EHorizontalAlignment::HAlign_Right)
 			[
 				SNew(STextBlock)
-			.Text(FText::FromString(Category))
+			.Text(Entry->Category)
 			.MinDesiredWidth(300.0f)
 			.ColorAndOpacity(FLinearColor(0.5, 0.5, 0.5, 0.5))
 			.Justification(ETextJustify::Right)
@@ -155,42 +234,62 @@ TSharedRef<SWidget> FRedEditorIconPathCustomization::HandleGenerateWidget(TShare
 	return SNew(STextBlock).Text(FText::FromString(FString("Path doesn't exist.")));
 }
 
-void FRedEditorIconPathCustomization::CustomizeChildren(TSharedRef<IPropertyHandle> StructPropertyHandle,
-                                                        class IDetailChildrenBuilder& StructBuilder,
-                                                        IPropertyTypeCustomizationUtils& StructCustomizationUtils)
+TSharedRef<SWidget> FRedEditorIconPathCustomization::HandleGenerateStyleWidget(TSharedPtr<FString> InItem)
 {
-}
-
-TArray<FString> FRedEditorIconPathCustomization::GetIconOptionsFromPath()
-{
-	TArray<FString> OutFoundIcons;
-	const URedDeveloperSettings* RedSettings = GetDefault<URedDeveloperSettings>();
-	for (const FString& Path : RedSettings->EditorIconWidgetSearchPaths)
+	const TSharedPtr<const FRedEditorStyleIconEntry> Entry = InItem.IsValid()
+		                                                         ? FRedEditorIconIndex::Get().FindStyleEntry(*InItem)
+		                                                         : nullptr;
+	if (!Entry.IsValid())
 	{
-		GetIconsFromPath(Path, OutFoundIcons);
+		return SNew(STextBlock).Text(LOCTEXT("StyleNotRegistered", "Style is not registered."));
 	}
-	return OutFoundIcons;
-}
 
-TArray<TSharedPtr<FString>>* FRedEditorIconPathCustomization::GetIconOptionsPointer()
-{
-	if (CachedIconOptions.Num() == 0)
+	// Resolved by name on every paint so rows never hold on to a brush from a style set that has been unregistered.
+	const FName StyleSetName = Entry->StyleSetName;
+	const FName StyleName = Entry->StyleName;
+	auto GetBrush = [StyleSetName, StyleName]() -> const FSlateBrush*
 	{
-		Algo::Transform(GetIconOptionsFromPath(), CachedIconOptions, [](const FString& InString)
-		{
-			return MakeShared<FString>(InString);
-		});
-	}
+		const ISlateStyle* Style = FSlateStyleRegistry::FindSlateStyle(StyleSetName);
+		return Style != nullptr ? Style->GetOptionalBrush(StyleName, nullptr, nullptr) : nullptr;
+	};
 
-	return &CachedIconOptions;
+	return SNew(SHorizontalBox)
+		.ToolTipText(FText::FromString(*Entry->Key))
+		+ SHorizontalBox::Slot()
+		  .AutoWidth()
+		  .VAlign(EVerticalAlignment::VAlign_Center)
+		[
+			SNew(SImage)
+			.Image_Lambda(GetBrush)
+			.DesiredSizeOverride(FVector2D(24, 24))
+		]
+		+ SHorizontalBox::Slot()
+		  .AutoWidth()
+		  .Padding(16.0f, 1.0f)
+		  .VAlign(EVerticalAlignment::VAlign_Center)
+		[
+			SNew(STextBlock)
+			.Text(Entry->DisplayName)
+			.MinDesiredWidth(200.0f)
+		]
+		+ SHorizontalBox::Slot()
+		  .FillWidth(1.0f)
+		  .Padding(16.0f, 1.0f, 0.0f, 1.0f)
+		  .VAlign(EVerticalAlignment::VAlign_Center)
+		  .HAlign(EHorizontalAlignment::HAlign_Right)
+		[
+			SNew(STextBlock)
+			.Text(Entry->Category)
+			.MinDesiredWidth(300.0f)
+			.ColorAndOpacity(FLinearColor(0.5, 0.5, 0.5, 0.5))
+			.Justification(ETextJustify::Right)
+		];
 }
 
-
-void FRedEditorIconPathCustomization::GetIconsFromPath(const FString& InPath, TArray<FString>& OutFoundIcons)
+void FRedEditorIconPathCustomization::CustomizeChildren(TSharedRef<IPropertyHandle> StructPropertyHandle,
+                                                        class IDetailChildrenBuilder& StructBuilder,
+                                                        IPropertyTypeCustomizationUtils& StructCustomizationUtils)
 {
-	const FString SearchDirectory = FPaths::EngineDir() / InPath;
-	IFileManager::Get().FindFilesRecursive(OutFoundIcons, *SearchDirectory, TEXT("*.png"), true, false, false);
-	IFileManager::Get().FindFilesRecursive(OutFoundIcons, *SearchDirectory, TEXT("*.svg"), true, false, false);
 }
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,70 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedAssetRegistryTagWriter.h"
+
+#include "Misc/EngineVersion.h"
+
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4
+#include "UObject/AssetRegistryTagsContext.h"
+#endif
+
+FDelegateHandle FRedAssetRegistryTagWriter::Register(const FName TagName, TFunction<bool(const UObject*)> ShouldWrite,
+                                                     TFunction<FString(const UObject*)> MakeValue)
+{
+	auto WriteTag = [TagName, ShouldWrite = MoveTemp(ShouldWrite), MakeValue = MoveTemp(MakeValue)](
+		const UObject* Object, TFunctionRef<void(UObject::FAssetRegistryTag&&)> AddTag)
+	{
+		if (Object == nullptr || Object->HasAnyFlags(RF_ClassDefaultObject | RF_Transient) || !ShouldWrite(Object))
+		{
+			return;
+		}
+		AddTag(UObject::FAssetRegistryTag(TagName, MakeValue(Object), UObject::FAssetRegistryTag::TT_Hidden));
+	};
+
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4
+	return UObject::FAssetRegistryTag::OnGetExtraObjectTagsWithContext.AddLambda(
+		[WriteTag = MoveTemp(WriteTag)](FAssetRegistryTagsContext Context)
+		{
+			WriteTag(Context.GetObject(), [&Context](UObject::FAssetRegistryTag&& Tag)
+			{
+				Context.AddTag(MoveTemp(Tag));
+			});
+		});
+#else
+	return UObject::FAssetRegistryTag::OnGetExtraObjectTags.AddLambda(
+		[WriteTag = MoveTemp(WriteTag)](const UObject* Object, TArray<UObject::FAssetRegistryTag>& InOutTags)
+		{
+			WriteTag(Object, [&InOutTags](UObject::FAssetRegistryTag&& Tag) { InOutTags.Add(MoveTemp(Tag)); });
+		});
+#endif
+}
+
+void FRedAssetRegistryTagWriter::Unregister(FDelegateHandle& Handle)
+{
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4
+	UObject::FAssetRegistryTag::OnGetExtraObjectTagsWithContext.Remove(Handle);
+#else
+	UObject::FAssetRegistryTag::OnGetExtraObjectTags.Remove(Handle);
+#endif
+	Handle.Reset();
+}
@@ -0,0 +1,339 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedDataTableDiff.h"
+
+#include "RedDataTableExport.h"
+#include "RedDataTableImport.h"
+#include "Async/ParallelFor.h"
+#include "DataTableUtils.h"
+#include "Engine/DataTable.h"
+#include "HAL/FileManager.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+
+namespace RedDataTableDiff
+{
+	/**
+	 * Cell and row hashes of one side of a diff, rows in their original order. Which cells are present is kept apart
+	 * from their hashes, an empty cell hashes to 0 too and adding or removing a column must still show up as a change.
+	 */
+	struct FHashedRows
+	{
+		TArray<FName> Names;
+		TArray<TArray<uint32>> CellHashes;
+		TArray<TBitArray<>> CellsPresent;
+		TArray<uint32> RowHashes;
+		TMap<FName, int32> Indices;
+
+		void Init(const int32 NumRows)
+		{
+			Names.SetNum(NumRows);
+			CellHashes.SetNum(NumRows);
+			CellsPresent.SetNum(NumRows);
+			RowHashes.SetNum(NumRows);
+		}
+
+		bool CellsDiffer(const int32 Index, const FHashedRows& Other, const int32 OtherIndex, const int32 Column) const
+		{
+			return CellsPresent[Index][Column] != Other.CellsPresent[OtherIndex][Column]
+				|| CellHashes[Index][Column] != Other.CellHashes[OtherIndex][Column];
+		}
+
+		void Finish()
+		{
+			ParallelFor(Names.Num(), [this](const int32 Index)
+			{
+				const TArray<uint32>& Hashes = CellHashes[Index];
+				uint32 RowHash = FCrc::MemCrc32(Hashes.GetData(), Hashes.Num() * sizeof(uint32));
+				for (TConstSetBitIterator<> It(CellsPresent[Index]); It; ++It)
+				{
+					RowHash = HashCombine(RowHash, It.GetIndex());
+				}
+				RowHashes[Index] = RowHash;
+			});
+			Indices.Reserve(Names.Num());
+			for (int32 Index = 0; Index < Names.Num(); ++Index)
+			{
+				Indices.Add(Names[Index], Index);
+			}
+		}
+	};
+
+	/** Hashes every row of DataTable in Columns, a null column is missing. */
+	FHashedRows HashTable(const UDataTable* DataTable, TConstArrayView<const FProperty*> Columns,
+	                      const ERedDataTableFormat Format, const FRedDataTableExportOptions& Options)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(RedDataTableDiff::HashTable);
+
+		TArray<const uint8*> RowData;
+		FHashedRows Rows;
+		Rows.Init(DataTable->GetRowMap().Num());
+		RowData.Reserve(Rows.Names.Num());
+		for (const TPair<FName, uint8*>& Row : DataTable->GetRowMap())
+		{
+			Rows.Names[RowData.Num()] = Row.Key;
+			RowData.Add(Row.Value);
+		}
+
+		ParallelFor(RowData.Num(), [&](const int32 Index)
+		{
+			TArray<uint32>& CellHashes = Rows.CellHashes[Index];
+			TBitArray<>& CellsPresent = Rows.CellsPresent[Index];
+			CellHashes.Init(0, Columns.Num());
+			CellsPresent.Init(false, Columns.Num());
+			for (int32 Column = 0; Column < Columns.Num(); ++Column)
+			{
+				if (Columns[Column] != nullptr)
+				{
+					CellHashes[Column] = FRedDataTableFile::HashCell(Columns[Column], RowData[Index], Format, Options);
+					CellsPresent[Column] = true;
+				}
+			}
+		});
+		Rows.Finish();
+		return Rows;
+	}
+
+	/** Takes the hashes read with the file, NumColumns can be more than the file has for columns only the table has. */
+	FHashedRows HashFile(const FRedDataTableFile& File, const int32 NumColumns)
+	{
+		FHashedRows Rows;
+		for (const FRedDataTableFile::FRow& Row : File.Rows)
+		{
+			if (!Row.bValid)
+			{
+				continue;
+			}
+
+			Rows.Names.Add(Row.Name);
+			TArray<uint32>& CellHashes = Rows.CellHashes.AddDefaulted_GetRef();
+			TBitArray<>& CellsPresent = Rows.CellsPresent.AddDefaulted_GetRef();
+			CellHashes.Init(0, NumColumns);
+			CellsPresent.Init(false, NumColumns);
+			for (int32 Column = 0; Column < File.ColumnNames.Num(); ++Column)
+			{
+				if (Row.HasCell(Column))
+				{
+					CellHashes[Column] = Row.CellHashes[Column];
+					CellsPresent[Column] = true;
+				}
+			}
+		}
+		Rows.RowHashes.SetNum(Rows.Names.Num());
+		Rows.Finish();
+		return Rows;
+	}
+
+	TArray<FRedDataTableRowDiff> Diff(const FHashedRows& Old, const FHashedRows& New, TConstArrayView<FName> Columns)
+	{
+		TArray<FRedDataTableRowDiff> Diffs;
+		for (int32 NewIndex = 0; NewIndex < New.Names.Num(); ++NewIndex)
+		{
+			const int32* OldIndex = Old.Indices.Find(New.Names[NewIndex]);
+			if (OldIndex == nullptr)
+			{
+				FRedDataTableRowDiff& Diff = Diffs.AddDefaulted_GetRef();
+				Diff.RowName = New.Names[NewIndex];
+				Diff.Change = ERedDataTableRowChange::Added;
+				continue;
+			}
+			if (Old.RowHashes[*OldIndex] == New.RowHashes[NewIndex])
+			{
+				continue;
+			}
+
+			FRedDataTableRowDiff& Diff = Diffs.AddDefaulted_GetRef();
+			Diff.RowName = New.Names[NewIndex];
+			Diff.Change = ERedDataTableRowChange::Changed;
+			for (int32 Column = 0; Column < Columns.Num(); ++Column)
+			{
+				if (Old.CellsDiffer(*OldIndex, New, NewIndex, Column))
+				{
+					Diff.ChangedColumns.Add(Columns[Column]);
+				}
+			}
+		}
+
+		for (const FName RowName : Old.Names)
+		{
+			if (!New.Indices.Contains(RowName))
+			{
+				FRedDataTableRowDiff& Diff = Diffs.AddDefaulted_GetRef();
+				Diff.RowName = RowName;
+				Diff.Change = ERedDataTableRowChange::Removed;
+			}
+		}
+		return Diffs;
+	}
+
+	FString GetChangeName(const ERedDataTableRowChange Change)
+	{
+		return StaticEnum<ERedDataTableRowChange>()->GetNameStringByValue(static_cast<int64>(Change));
+	}
+}
+
+TArray<FRedDataTableRowDiff> FRedDataTableDiff::DiffTables(const UDataTable* Old, const UDataTable* New)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedDataTableDiff::DiffTables);
+	using namespace RedDataTableDiff;
+
+	if (!IsValid(Old) || !IsValid(New) || Old->GetRowStruct() == nullptr || New->GetRowStruct() == nullptr)
+	{
+		return {};
+	}
+
+	// Old's columns in order, then the columns only New has.
+	TArray<FName> Columns;
+	TArray<const FProperty*> OldColumns;
+	TArray<const FProperty*> NewColumns;
+	for (TFieldIterator<const FProperty> It(Old->GetRowStruct()); It; ++It)
+	{
+		Columns.Add(FName(DataTableUtils::GetPropertyExportName(*It)));
+		OldColumns.Add(*It);
+		NewColumns.Add(nullptr);
+	}
+	for (TFieldIterator<const FProperty> It(New->GetRowStruct()); It; ++It)
+	{
+		const FName Column(DataTableUtils::GetPropertyExportName(*It));
+		const int32 Index = Columns.Find(Column);
+		if (Index != INDEX_NONE)
+		{
+			NewColumns[Index] = *It;
+		}
+		else
+		{
+			Columns.Add(Column);
+			OldColumns.Add(nullptr);
+			NewColumns.Add(*It);
+		}
+	}
+
+	// Both sides are hashed the same way, so the export options don't matter here.
+	const FRedDataTableExportOptions Options;
+	return Diff(HashTable(Old, OldColumns, ERedDataTableFormat::Csv, Options),
+	            HashTable(New, NewColumns, ERedDataTableFormat::Csv, Options), Columns);
+}
+
+bool FRedDataTableDiff::DiffWithSnapshot(const FString& SnapshotFilename, const UDataTable* DataTable,
+                                         const FRedDataTableExportOptions& ExportOptions,
+                                         TArray<FRedDataTableRowDiff>& OutDiffs)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedDataTableDiff::DiffWithSnapshot);
+	using namespace RedDataTableDiff;
+
+	OutDiffs.Reset();
+	if (!IsValid(DataTable) || DataTable->GetRowStruct() == nullptr)
+	{
+		return false;
+	}
+
+	FRedDataTableFile Snapshot;
+	if (!Snapshot.Read(SnapshotFilename))
+	{
+		return false;
+	}
+
+	// The snapshot's columns in order, then the columns only the table has.
+	TArray<FName> Columns;
+	for (const FString& ColumnName : Snapshot.ColumnNames)
+	{
+		Columns.Add(FName(ColumnName));
+	}
+	TArray<const FProperty*> TableColumns = Snapshot.FindColumnProperties(DataTable->GetRowStruct());
+	for (TFieldIterator<const FProperty> It(DataTable->GetRowStruct()); It; ++It)
+	{
+		if (!TableColumns.Contains(*It))
+		{
+			Columns.Add(FName(DataTableUtils::GetPropertyExportName(*It)));
+			TableColumns.Add(*It);
+		}
+	}
+
+	OutDiffs = Diff(HashFile(Snapshot, Columns.Num()),
+	                HashTable(DataTable, TableColumns, Snapshot.Format, ExportOptions), Columns);
+	return true;
+}
+
+bool FRedDataTableDiff::ExportDiffs(TConstArrayView<FRedDataTableRowDiff> Diffs, const FString& Filename)
+{
+	using namespace RedDataTableDiff;
+
+	const TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Archive)
+	{
+		UE_LOG(LogRedDataTable, Error, TEXT("Could not open '%s' for writing."), *Filename);
+		return false;
+	}
+
+	auto WriteString = [&Archive](const FString& String)
+	{
+		const FTCHARToUTF8 Utf8(*String, String.Len());
+		Archive->Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+	};
+
+	const bool bJson = FRedDataTableExport::GetFormatFromFilename(Filename) == ERedDataTableFormat::Json;
+	WriteString(bJson ? TEXT("[") : TEXT("Row,Change,ChangedColumns\n"));
+	for (int32 Index = 0; Index < Diffs.Num(); ++Index)
+	{
+		const FRedDataTableRowDiff& Diff = Diffs[Index];
+		TArray<FString> ChangedColumns;
+		for (const FName Column : Diff.ChangedColumns)
+		{
+			ChangedColumns.Add(Column.ToString());
+		}
+
+		if (bJson)
+		{
+			FString Line = Index > 0 ? TEXT(",\n") : TEXT("\n");
+			const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter =
+				TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Line);
+			JsonWriter->WriteObjectStart();
+			JsonWriter->WriteValue(TEXT("Row"), Diff.RowName.ToString());
+			JsonWriter->WriteValue(TEXT("Change"), GetChangeName(Diff.Change));
+			JsonWriter->WriteValue(TEXT("ChangedColumns"), ChangedColumns);
+			JsonWriter->WriteObjectEnd();
+			JsonWriter->Close();
+			WriteString(Line);
+		}
+		else
+		{
+			// The changed columns share one field, separated by ';'.
+			WriteString(FString::Printf(TEXT("%s,%s,%s\n"),
+			                            *FRedDataTableExport::EscapeCsvField(Diff.RowName.ToString()),
+			                            *GetChangeName(Diff.Change),
+			                            *FRedDataTableExport::EscapeCsvField(
+				                            FString::Join(ChangedColumns, TEXT(";")))));
+		}
+	}
+	if (bJson)
+	{
+		WriteString(TEXT("\n]\n"));
+	}
+
+	if (!Archive->Close())
+	{
+		UE_LOG(LogRedDataTable, Error, TEXT("Could not write '%s'."), *Filename);
+		return false;
+	}
+	return true;
+}
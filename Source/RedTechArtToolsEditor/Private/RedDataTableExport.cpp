@@ -0,0 +1,334 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedDataTableExport.h"
+
+#include "Async/ParallelFor.h"
+#include "DataTableUtils.h"
+#include "Engine/DataTable.h"
+#include "HAL/FileManager.h"
+#include "JsonObjectConverter.h"
+#include "Misc/Paths.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY(LogRedDataTable);
+
+namespace RedDataTableExport
+{
+	EDataTableExportFlags GetExportFlags(const FRedDataTableExportOptions& Options)
+	{
+		EDataTableExportFlags Flags = EDataTableExportFlags::None;
+		if (Options.bUseJsonObjectsForStructs)
+		{
+			Flags |= EDataTableExportFlags::UseJsonObjectsForStructs;
+		}
+		if (Options.bUseSimpleText)
+		{
+			Flags |= EDataTableExportFlags::UseSimpleText;
+		}
+		return Flags;
+	}
+
+	/** The row struct properties to export in struct order, only those named in Columns unless it is empty. */
+	TArray<const FProperty*> GetColumns(const UScriptStruct* RowStruct, const TArray<FName>& Columns,
+	                                    const EDataTableExportFlags Flags)
+	{
+		TArray<const FProperty*> Properties;
+		for (TFieldIterator<const FProperty> It(RowStruct); It; ++It)
+		{
+			const FProperty* Property = *It;
+			if (Columns.Num() == 0 || Columns.Contains(Property->GetFName())
+				|| Columns.Contains(FName(DataTableUtils::GetPropertyExportName(Property, Flags))))
+			{
+				Properties.Add(Property);
+			}
+		}
+		return Properties;
+	}
+
+	FString MakeCsvHeader(TConstArrayView<const FProperty*> Columns, const EDataTableExportFlags Flags)
+	{
+		FString Header = TEXT("---");
+		for (const FProperty* Property : Columns)
+		{
+			Header += TEXT(",");
+			Header += FRedDataTableExport::EscapeCsvField(DataTableUtils::GetPropertyExportName(Property, Flags));
+		}
+		Header += TEXT("\n");
+		return Header;
+	}
+
+	void AppendCsvRow(FString& Out, const FName RowName, const uint8* RowData,
+	                  TConstArrayView<const FProperty*> Columns, const EDataTableExportFlags Flags)
+	{
+		Out += FRedDataTableExport::EscapeCsvField(RowName.ToString());
+		for (const FProperty* Property : Columns)
+		{
+			Out += TEXT(",");
+			Out += FRedDataTableExport::EscapeCsvField(
+				DataTableUtils::GetPropertyValueAsString(Property, RowData, Flags));
+		}
+		Out += TEXT("\n");
+	}
+
+	TSharedPtr<FJsonValue> MakeJsonValue(const FProperty* Property, const uint8* RowData,
+	                                     const EDataTableExportFlags Flags)
+	{
+		// Structs are written as their export text unless asked for objects, like the engine's exporter does.
+		if (Property->IsA<FStructProperty>()
+			&& !EnumHasAnyFlags(Flags, EDataTableExportFlags::UseJsonObjectsForStructs))
+		{
+			return MakeShared<FJsonValueString>(DataTableUtils::GetPropertyValueAsString(Property, RowData, Flags));
+		}
+		return FJsonObjectConverter::UPropertyToJsonValue(const_cast<FProperty*>(Property),
+		                                                  Property->ContainerPtrToValuePtr<void>(RowData));
+	}
+
+	void AppendJsonRow(FString& Out, const FName RowName, const uint8* RowData,
+	                   TConstArrayView<const FProperty*> Columns, const EDataTableExportFlags Flags)
+	{
+		const TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("Name"), RowName.ToString());
+		for (const FProperty* Property : Columns)
+		{
+			if (TSharedPtr<FJsonValue> Value = MakeJsonValue(Property, RowData, Flags))
+			{
+				Object->SetField(DataTableUtils::GetPropertyExportName(Property, Flags), MoveTemp(Value));
+			}
+		}
+
+		const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter =
+			TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Out);
+		FJsonSerializer::Serialize(Object, JsonWriter);
+	}
+
+	using FRow = TPair<FName, const uint8*>;
+
+	/** Calls Visitor with the rows in the options' range, in table order. */
+	void ForEachRowInRange(const UDataTable* DataTable, const FRedDataTableExportOptions& Options,
+	                       TFunctionRef<void(FName, const uint8*)> Visitor)
+	{
+		const int64 FirstRow = FMath::Max(0, Options.FirstRow);
+		const int64 EndRow = Options.NumRows < 0 ? MAX_int64 : FirstRow + Options.NumRows;
+		int64 RowIndex = -1;
+		for (const TPair<FName, uint8*>& Row : DataTable->GetRowMap())
+		{
+			if (++RowIndex < FirstRow)
+			{
+				continue;
+			}
+			if (RowIndex >= EndRow)
+			{
+				break;
+			}
+			Visitor(Row.Key, Row.Value);
+		}
+	}
+
+	FString MakeHeader(const ERedDataTableFormat Format, TConstArrayView<const FProperty*> Columns,
+	                   const EDataTableExportFlags Flags)
+	{
+		return Format == ERedDataTableFormat::Json ? FString(TEXT("[")) : MakeCsvHeader(Columns, Flags);
+	}
+
+	const TCHAR* GetFooter(const ERedDataTableFormat Format)
+	{
+		return Format == ERedDataTableFormat::Json ? TEXT("\n]\n") : TEXT("");
+	}
+
+	/**
+	 * Formats Rows into OutLines in the same order. FirstRowIndex is the position of the first row in the whole
+	 * export, JSON rows after the very first one start with a separator.
+	 */
+	void FormatRows(TConstArrayView<FRow> Rows, const int32 FirstRowIndex, const ERedDataTableFormat Format,
+	                TConstArrayView<const FProperty*> Columns, const EDataTableExportFlags Flags,
+	                TArray<FString>& OutLines)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(RedDataTableExport::FormatRows);
+
+		OutLines.SetNum(Rows.Num());
+		// Exporting a property as text only reads the row, so rows are independent and formatted on worker threads.
+		ParallelFor(Rows.Num(), [&](const int32 Index)
+		{
+			FString& Line = OutLines[Index];
+			Line.Reset();
+			if (Format == ERedDataTableFormat::Json)
+			{
+				Line += FirstRowIndex + Index > 0 ? TEXT(",\n") : TEXT("\n");
+				AppendJsonRow(Line, Rows[Index].Key, Rows[Index].Value, Columns, Flags);
+			}
+			else
+			{
+				AppendCsvRow(Line, Rows[Index].Key, Rows[Index].Value, Columns, Flags);
+			}
+		});
+	}
+}
+
+ERedDataTableFormat FRedDataTableExport::GetFormatFromFilename(const FString& Filename)
+{
+	return FPaths::GetExtension(Filename).Equals(TEXT("json"), ESearchCase::IgnoreCase)
+		       ? ERedDataTableFormat::Json
+		       : ERedDataTableFormat::Csv;
+}
+
+bool FRedDataTableExport::ExportToFile(const UDataTable* DataTable, const FString& Filename,
+                                       const FRedDataTableExportOptions& Options, FRedDataTableExportStats& OutStats)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedDataTableExport::ExportToFile);
+	using namespace RedDataTableExport;
+
+	OutStats = FRedDataTableExportStats();
+	if (!IsValid(DataTable) || DataTable->GetRowStruct() == nullptr)
+	{
+		return false;
+	}
+
+	const TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Archive)
+	{
+		UE_LOG(LogRedDataTable, Error, TEXT("Could not open '%s' for writing."), *Filename);
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const ERedDataTableFormat Format = GetFormatFromFilename(Filename);
+	const EDataTableExportFlags Flags = GetExportFlags(Options);
+	const TArray<const FProperty*> Columns = GetColumns(DataTable->GetRowStruct(), Options.Columns, Flags);
+	const int32 RowsPerChunk = FMath::Max(1, Options.RowsPerChunk);
+
+	// The chunk buffers keep their allocations between writes, so memory use stays the same however large the table is.
+	TArray<FRow> ChunkRows;
+	ChunkRows.Reserve(RowsPerChunk);
+	TArray<FString> Lines;
+	FString Chunk = MakeHeader(Format, Columns, Flags);
+	auto WriteChunk = [&](const bool bLastChunk)
+	{
+		FormatRows(ChunkRows, OutStats.NumRows, Format, Columns, Flags, Lines);
+		for (const FString& Line : Lines)
+		{
+			Chunk += Line;
+		}
+		OutStats.NumRows += ChunkRows.Num();
+		ChunkRows.Reset();
+		if (bLastChunk)
+		{
+			Chunk += GetFooter(Format);
+		}
+
+		const FTCHARToUTF8 Utf8(*Chunk, Chunk.Len());
+		Archive->Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+		OutStats.NumBytes += Utf8.Length();
+		Chunk.Reset();
+	};
+
+	ForEachRowInRange(DataTable, Options, [&](const FName RowName, const uint8* RowData)
+	{
+		ChunkRows.Emplace(RowName, RowData);
+		if (ChunkRows.Num() == RowsPerChunk)
+		{
+			WriteChunk(false);
+		}
+	});
+	WriteChunk(true);
+	const bool bWritten = Archive->Close();
+
+	OutStats.NumColumns = Columns.Num();
+	OutStats.Seconds = FPlatformTime::Seconds() - StartTime;
+	OutStats.MegabytesPerSecond = OutStats.Seconds > 0.0
+		                              ? static_cast<double>(OutStats.NumBytes) / (1024.0 * 1024.0) / OutStats.Seconds
+		                              : 0.0;
+	if (!bWritten)
+	{
+		UE_LOG(LogRedDataTable, Error, TEXT("Could not write '%s'."), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogRedDataTable, Display, TEXT("Exported %d rows of '%s' to '%s', %.1f MB in %.2fs (%.1f MB/s)."),
+	       OutStats.NumRows, *DataTable->GetPathName(), *Filename,
+	       static_cast<double>(OutStats.NumBytes) / (1024.0 * 1024.0), OutStats.Seconds,
+	       OutStats.MegabytesPerSecond);
+	return true;
+}
+
+FString FRedDataTableExport::ExportToString(const UDataTable* DataTable, const ERedDataTableFormat Format,
+                                            const FRedDataTableExportOptions& Options)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedDataTableExport::ExportToString);
+	using namespace RedDataTableExport;
+
+	if (!IsValid(DataTable) || DataTable->GetRowStruct() == nullptr)
+	{
+		return FString();
+	}
+
+	const EDataTableExportFlags Flags = GetExportFlags(Options);
+	const TArray<const FProperty*> Columns = GetColumns(DataTable->GetRowStruct(), Options.Columns, Flags);
+	TArray<FRow> Rows;
+	ForEachRowInRange(DataTable, Options, [&Rows](const FName RowName, const uint8* RowData)
+	{
+		Rows.Emplace(RowName, RowData);
+	});
+
+	TArray<FString> Lines;
+	FormatRows(Rows, 0, Format, Columns, Flags, Lines);
+
+	FString Result = MakeHeader(Format, Columns, Flags);
+	const TCHAR* Footer = GetFooter(Format);
+	int32 Length = Result.Len() + FCString::Strlen(Footer);
+	for (const FString& Line : Lines)
+	{
+		Length += Line.Len();
+	}
+	Result.Reserve(Length);
+	for (const FString& Line : Lines)
+	{
+		Result += Line;
+	}
+	Result += Footer;
+	return Result;
+}
+
+FString FRedDataTableExport::FormatCsvCell(const FProperty* Property, const uint8* RowData,
+                                           const FRedDataTableExportOptions& Options)
+{
+	return DataTableUtils::GetPropertyValueAsString(Property, RowData, RedDataTableExport::GetExportFlags(Options));
+}
+
+FString FRedDataTableExport::EscapeCsvField(const FString& Field)
+{
+	int32 Index;
+	if (!Field.FindChar(TEXT(','), Index) && !Field.FindChar(TEXT('"'), Index)
+		&& !Field.FindChar(TEXT('\n'), Index) && !Field.FindChar(TEXT('\r'), Index))
+	{
+		return Field;
+	}
+	return TEXT("\"") + Field.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+}
+
+TSharedPtr<FJsonValue> FRedDataTableExport::FormatJsonCell(const FProperty* Property, const uint8* RowData,
+                                                           const FRedDataTableExportOptions& Options)
+{
+	return RedDataTableExport::MakeJsonValue(Property, RowData, RedDataTableExport::GetExportFlags(Options));
+}
@@ -0,0 +1,594 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedDataTableImport.h"
+
+#include "Async/ParallelFor.h"
+#include "DataTableEditorUtils.h"
+#include "DataTableUtils.h"
+#include "Engine/DataTable.h"
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "ScopedTransaction.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/StructOnScope.h"
+
+#define LOCTEXT_NAMESPACE "RedDataTableImport"
+
+namespace RedDataTableImport
+{
+	/**
+	 * Splits CSV text into records, a newline in a quoted field doesn't end the record. Blank lines are skipped.
+	 * Returns false if the text ends inside a quoted field.
+	 */
+	bool SplitCsvRecords(const FString& Text, TArray<FStringView>& OutRecords)
+	{
+		auto AddRecord = [&Text, &OutRecords](const int32 Start, const int32 End)
+		{
+			const FStringView Record = FStringView(Text).Mid(Start, End - Start);
+			if (!Record.TrimStartAndEnd().IsEmpty())
+			{
+				OutRecords.Add(Record);
+			}
+		};
+
+		bool bInQuotes = false;
+		int32 Start = 0;
+		for (int32 Index = 0; Index < Text.Len(); ++Index)
+		{
+			const TCHAR Char = Text[Index];
+			if (Char == TEXT('"'))
+			{
+				bInQuotes = !bInQuotes;
+			}
+			else if (Char == TEXT('\n') && !bInQuotes)
+			{
+				AddRecord(Start, Index);
+				Start = Index + 1;
+			}
+		}
+		AddRecord(Start, Text.Len());
+		return !bInQuotes;
+	}
+
+	/** Splits a CSV record into fields, returns false if a quoted field isn't closed. */
+	bool ParseCsvRecord(const FStringView Record, TArray<FString>& OutFields)
+	{
+		OutFields.Reset();
+		FString Field;
+		bool bInQuotes = false;
+		for (int32 Index = 0; Index < Record.Len(); ++Index)
+		{
+			const TCHAR Char = Record[Index];
+			if (bInQuotes)
+			{
+				if (Char == TEXT('"'))
+				{
+					if (Index + 1 < Record.Len() && Record[Index + 1] == TEXT('"'))
+					{
+						Field.AppendChar(TEXT('"'));
+						++Index;
+					}
+					else
+					{
+						bInQuotes = false;
+					}
+				}
+				else
+				{
+					Field.AppendChar(Char);
+				}
+			}
+			else if (Char == TEXT('"'))
+			{
+				bInQuotes = true;
+			}
+			else if (Char == TEXT(','))
+			{
+				OutFields.Add(MoveTemp(Field));
+				Field.Reset();
+			}
+			else if (Char != TEXT('\r'))
+			{
+				Field.AppendChar(Char);
+			}
+		}
+		OutFields.Add(MoveTemp(Field));
+		return !bInQuotes;
+	}
+
+	/**
+	 * Parses the layout FRedDataTableExport writes, one row object per line between "[" and "]", in parallel.
+	 * Returns false for any other layout, which is then parsed as a single document.
+	 */
+	bool ParseJsonRowLines(const FString& Text, TArray<TSharedPtr<FJsonObject>>& OutObjects)
+	{
+		TArray<FStringView> Lines;
+		int32 Start = 0;
+		for (int32 Index = 0; Index <= Text.Len(); ++Index)
+		{
+			if (Index == Text.Len() || Text[Index] == TEXT('\n'))
+			{
+				const FStringView Line = FStringView(Text).Mid(Start, Index - Start).TrimStartAndEnd();
+				if (!Line.IsEmpty())
+				{
+					Lines.Add(Line);
+				}
+				Start = Index + 1;
+			}
+		}
+		if (Lines.Num() < 2 || Lines[0] != TEXT("[") || Lines.Last() != TEXT("]"))
+		{
+			return false;
+		}
+
+		OutObjects.SetNum(Lines.Num() - 2);
+		ParallelFor(OutObjects.Num(), [&](const int32 Index)
+		{
+			FStringView Line = Lines[Index + 1];
+			if (Line.EndsWith(TEXT(",")))
+			{
+				Line.LeftChopInline(1);
+			}
+			const TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(FString(Line));
+			if (!FJsonSerializer::Deserialize(JsonReader, OutObjects[Index]))
+			{
+				OutObjects[Index].Reset();
+			}
+		});
+
+		for (const TSharedPtr<FJsonObject>& Object : OutObjects)
+		{
+			if (!Object.IsValid())
+			{
+				OutObjects.Reset();
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+bool FRedDataTableFile::Read(const FString& Filename)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedDataTableFile::Read);
+
+	ColumnNames.Reset();
+	Rows.Reset();
+	FString Text;
+	if (!FFileHelper::LoadFileToString(Text, *Filename))
+	{
+		UE_LOG(LogRedDataTable, Error, TEXT("Could not read '%s'."), *Filename);
+		return false;
+	}
+
+	Format = FRedDataTableExport::GetFormatFromFilename(Filename);
+	const bool bParsed = Format == ERedDataTableFormat::Json ? ParseJson(Text) : ParseCsv(Text);
+	if (!bParsed)
+	{
+		UE_LOG(LogRedDataTable, Error, TEXT("'%s' is not a DataTable %s file."), *Filename,
+		       Format == ERedDataTableFormat::Json ? TEXT("JSON") : TEXT("CSV"));
+		return false;
+	}
+
+	for (int32 Index = 0; Index < Rows.Num(); ++Index)
+	{
+		if (!Rows[Index].bValid)
+		{
+			UE_LOG(LogRedDataTable, Warning, TEXT("Skipping malformed row %d in '%s'."), Index + 1, *Filename);
+		}
+	}
+	return true;
+}
+
+bool FRedDataTableFile::ParseCsv(const FString& Text)
+{
+	using namespace RedDataTableImport;
+
+	// An unclosed quote swallows every record after it, so the whole file is rejected rather than importing the
+	// rows before it and removing the rest.
+	TArray<FStringView> Records;
+	TArray<FString> Header;
+	if (!SplitCsvRecords(Text, Records) || Records.Num() == 0 || !ParseCsvRecord(Records[0], Header))
+	{
+		return false;
+	}
+
+	// The first header cell is the row name column, "---" in the engine's layout.
+	ColumnNames.Append(TConstArrayView<FString>(Header).RightChop(1));
+	Rows.SetNum(Records.Num() - 1);
+	ParallelFor(Rows.Num(), [&](const int32 Index)
+	{
+		FRow& Row = Rows[Index];
+		TArray<FString> Fields;
+		if (!ParseCsvRecord(Records[Index + 1], Fields) || Fields[0].IsEmpty())
+		{
+			Row.bValid = false;
+			return;
+		}
+
+		Row.Name = FName(Fields[0]);
+		Row.Cells.Reserve(Fields.Num() - 1);
+		Row.CellHashes.Reserve(Fields.Num() - 1);
+		for (int32 FieldIndex = 1; FieldIndex < Fields.Num() && FieldIndex <= ColumnNames.Num(); ++FieldIndex)
+		{
+			Row.CellHashes.Add(HashCell(Fields[FieldIndex]));
+			Row.Cells.Add(MoveTemp(Fields[FieldIndex]));
+		}
+	});
+	return true;
+}
+
+bool FRedDataTableFile::ParseJson(const FString& Text)
+{
+	TArray<TSharedPtr<FJsonObject>> Objects;
+	if (!RedDataTableImport::ParseJsonRowLines(Text, Objects))
+	{
+		TArray<TSharedPtr<FJsonValue>> Values;
+		const TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(Text);
+		if (!FJsonSerializer::Deserialize(JsonReader, Values))
+		{
+			return false;
+		}
+
+		Objects.Reserve(Values.Num());
+		for (const TSharedPtr<FJsonValue>& Value : Values)
+		{
+			const TSharedPtr<FJsonObject>* Object = nullptr;
+			Objects.Add(Value.IsValid() && Value->TryGetObject(Object) ? *Object : nullptr);
+		}
+	}
+
+	// Rows may leave out fields, the columns are every field any row has, in the order they first appear.
+	TMap<FString, int32> ColumnIndices;
+	for (const TSharedPtr<FJsonObject>& Object : Objects)
+	{
+		if (!Object.IsValid())
+		{
+			continue;
+		}
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object->Values)
+		{
+			if (Field.Key != TEXT("Name") && !ColumnIndices.Contains(Field.Key))
+			{
+				ColumnIndices.Add(Field.Key, ColumnNames.Add(Field.Key));
+			}
+		}
+	}
+
+	Rows.SetNum(Objects.Num());
+	ParallelFor(Rows.Num(), [&](const int32 Index)
+	{
+		FRow& Row = Rows[Index];
+		FString RowName;
+		if (!Objects[Index].IsValid() || !Objects[Index]->TryGetStringField(TEXT("Name"), RowName) || RowName.IsEmpty())
+		{
+			Row.bValid = false;
+			return;
+		}
+
+		Row.Name = FName(RowName);
+		Row.Cells.SetNum(ColumnNames.Num());
+		Row.Values.SetNum(ColumnNames.Num());
+		Row.CellHashes.SetNumZeroed(ColumnNames.Num());
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Objects[Index]->Values)
+		{
+			if (const int32* Column = ColumnIndices.Find(Field.Key))
+			{
+				Row.Values[*Column] = Field.Value;
+				Row.Cells[*Column] = GetCellText(Field.Value);
+				Row.CellHashes[*Column] = HashCell(Row.Cells[*Column]);
+			}
+		}
+	});
+	return true;
+}
+
+TArray<const FProperty*> FRedDataTableFile::FindColumnProperties(const UScriptStruct* RowStruct) const
+{
+	TArray<const FProperty*> Properties;
+	Properties.Init(nullptr, ColumnNames.Num());
+	for (TFieldIterator<const FProperty> It(RowStruct); It; ++It)
+	{
+		const FProperty* Property = *It;
+		const FString ExportName = DataTableUtils::GetPropertyExportName(Property);
+		for (int32 Column = 0; Column < ColumnNames.Num(); ++Column)
+		{
+			if (Properties[Column] == nullptr
+				&& (ColumnNames[Column] == ExportName || ColumnNames[Column] == Property->GetName()))
+			{
+				Properties[Column] = Property;
+			}
+		}
+	}
+	return Properties;
+}
+
+FString FRedDataTableFile::ImportCell(const FRow& Row, const int32 Column, const FProperty* Property,
+                                      uint8* RowData) const
+{
+	// Strings go through the same text import as CSV, other JSON values are converted directly.
+	if (Row.Values.Num() > 0 && Row.Values[Column].IsValid() && Row.Values[Column]->Type != EJson::String)
+	{
+		if (!FJsonObjectConverter::JsonValueToUProperty(Row.Values[Column], const_cast<FProperty*>(Property),
+		                                                Property->ContainerPtrToValuePtr<void>(RowData)))
+		{
+			return FString::Printf(TEXT("'%s' is not a valid value."), *Row.Cells[Column]);
+		}
+		return FString();
+	}
+	return DataTableUtils::AssignStringToProperty(Row.Cells[Column], Property, RowData);
+}
+
+uint32 FRedDataTableFile::HashCell(const FStringView Text)
+{
+	return FCrc::MemCrc32(Text.GetData(), Text.Len() * sizeof(TCHAR));
+}
+
+uint32 FRedDataTableFile::HashCell(const FProperty* Property, const uint8* RowData,
+                                   const ERedDataTableFormat Format, const FRedDataTableExportOptions& Options)
+{
+	return Format == ERedDataTableFormat::Json
+		       ? HashCell(GetCellText(FRedDataTableExport::FormatJsonCell(Property, RowData, Options)))
+		       : HashCell(FRedDataTableExport::FormatCsvCell(Property, RowData, Options));
+}
+
+FString FRedDataTableFile::GetCellText(const TSharedPtr<FJsonValue>& Value)
+{
+	if (!Value.IsValid())
+	{
+		return FString();
+	}
+
+	switch (Value->Type)
+	{
+	case EJson::String:
+		return Value->AsString();
+	case EJson::Number:
+		return FString::Printf(TEXT("%.17g"), Value->AsNumber());
+	case EJson::Boolean:
+		return Value->AsBool() ? TEXT("true") : TEXT("false");
+	case EJson::Object:
+	case EJson::Array:
+		{
+			FString Text;
+			const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter =
+				TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Text);
+			if (Value->Type == EJson::Object)
+			{
+				FJsonSerializer::Serialize(Value->AsObject().ToSharedRef(), JsonWriter);
+			}
+			else
+			{
+				FJsonSerializer::Serialize(Value->AsArray(), JsonWriter);
+			}
+			return Text;
+		}
+	default:
+		return TEXT("null");
+	}
+}
+
+bool FRedDataTableImport::ImportFromFile(UDataTable* DataTable, const FString& Filename,
+                                         const FRedDataTableImportOptions& Options, FRedDataTableImportStats& OutStats)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedDataTableImport::ImportFromFile);
+
+	OutStats = FRedDataTableImportStats();
+	if (!IsValid(DataTable) || DataTable->GetRowStruct() == nullptr)
+	{
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	FRedDataTableFile File;
+	if (!File.Read(Filename))
+	{
+		return false;
+	}
+
+	const UScriptStruct* RowStruct = DataTable->GetRowStruct();
+	const TArray<const FProperty*> Columns = File.FindColumnProperties(RowStruct);
+	for (int32 Column = 0; Column < Columns.Num(); ++Column)
+	{
+		if (Columns[Column] == nullptr)
+		{
+			UE_LOG(LogRedDataTable, Warning, TEXT("'%s' has no column '%s', it is ignored."), *DataTable->GetPathName(),
+			       *File.ColumnNames[Column]);
+		}
+	}
+
+	TArray<uint8*> ExistingRows;
+	ExistingRows.SetNum(File.Rows.Num());
+	for (int32 Index = 0; Index < File.Rows.Num(); ++Index)
+	{
+		ExistingRows[Index] = File.Rows[Index].bValid ? DataTable->FindRowUnchecked(File.Rows[Index].Name) : nullptr;
+	}
+
+	// Existing rows are hashed in the file's format and compared a cell at a time, stopping at the first difference.
+	TArray<bool> MaybeChanged;
+	MaybeChanged.SetNumZeroed(File.Rows.Num());
+	ParallelFor(File.Rows.Num(), [&](const int32 Index)
+	{
+		const FRedDataTableFile::FRow& Row = File.Rows[Index];
+		if (!Row.bValid)
+		{
+			return;
+		}
+		if (ExistingRows[Index] == nullptr)
+		{
+			MaybeChanged[Index] = true;
+			return;
+		}
+		for (int32 Column = 0; Column < Columns.Num(); ++Column)
+		{
+			if (Columns[Column] != nullptr && Row.HasCell(Column) && Row.CellHashes[Column]
+				!= FRedDataTableFile::HashCell(Columns[Column], ExistingRows[Index], File.Format,
+				                               Options.ExportOptions))
+			{
+				MaybeChanged[Index] = true;
+				return;
+			}
+		}
+	});
+
+	// Rows with different text are imported into a copy and compared as values, so text that only differs in
+	// formatting, like 1.0 and 1, doesn't count as an edit.
+	TArray<TPair<int32, TUniquePtr<FStructOnScope>>> ChangedRows;
+	TSet<FName> FileRowNames;
+	FileRowNames.Reserve(File.Rows.Num());
+	for (int32 Index = 0; Index < File.Rows.Num(); ++Index)
+	{
+		const FRedDataTableFile::FRow& Row = File.Rows[Index];
+		if (!Row.bValid)
+		{
+			++OutStats.NumFailed;
+			continue;
+		}
+		FileRowNames.Add(Row.Name);
+		if (!MaybeChanged[Index])
+		{
+			++OutStats.NumUnchanged;
+			continue;
+		}
+
+		TUniquePtr<FStructOnScope> Scratch = MakeUnique<FStructOnScope>(RowStruct);
+		uint8* ScratchData = Scratch->GetStructMemory();
+		if (ExistingRows[Index] != nullptr)
+		{
+			RowStruct->CopyScriptStruct(ScratchData, ExistingRows[Index]);
+		}
+
+		bool bImported = true;
+		for (int32 Column = 0; Column < Columns.Num() && bImported; ++Column)
+		{
+			if (Columns[Column] == nullptr || !Row.HasCell(Column))
+			{
+				continue;
+			}
+			const FString Error = File.ImportCell(Row, Column, Columns[Column], ScratchData);
+			if (!Error.IsEmpty())
+			{
+				UE_LOG(LogRedDataTable, Warning, TEXT("Skipping row '%s', column '%s': %s"), *Row.Name.ToString(),
+				       *File.ColumnNames[Column], *Error);
+				bImported = false;
+			}
+		}
+
+		if (!bImported)
+		{
+			++OutStats.NumFailed;
+		}
+		else if (ExistingRows[Index] == nullptr)
+		{
+			ChangedRows.Emplace(Index, MoveTemp(Scratch));
+			++OutStats.NumAdded;
+		}
+		else if (RowStruct->CompareScriptStruct(ExistingRows[Index], ScratchData, PPF_None))
+		{
+			++OutStats.NumUnchanged;
+		}
+		else
+		{
+			ChangedRows.Emplace(Index, MoveTemp(Scratch));
+			++OutStats.NumUpdated;
+		}
+	}
+
+	// A row that failed to parse may be one of the table's rows, so nothing is removed unless every row was read.
+	TArray<FName> RemovedRows;
+	if (Options.bRemoveMissingRows && OutStats.NumFailed > 0)
+	{
+		UE_LOG(LogRedDataTable, Warning, TEXT("Not removing rows missing from '%s', %d of its rows failed to import."),
+		       *Filename, OutStats.NumFailed);
+	}
+	else if (Options.bRemoveMissingRows)
+	{
+		// Rows outside the exported range were never in the file, so they aren't missing from it.
+		const int32 FirstRow = FMath::Max(Options.ExportOptions.FirstRow, 0);
+		const int32 EndRow = Options.ExportOptions.NumRows < 0
+			                     ? MAX_int32
+			                     : FirstRow + Options.ExportOptions.NumRows;
+		int32 RowIndex = 0;
+		for (const TPair<FName, uint8*>& Row : DataTable->GetRowMap())
+		{
+			if (RowIndex >= FirstRow && RowIndex < EndRow && !FileRowNames.Contains(Row.Key))
+			{
+				RemovedRows.Add(Row.Key);
+			}
+			++RowIndex;
+		}
+	}
+	OutStats.NumRemoved = RemovedRows.Num();
+
+	if (!Options.bDryRun && (ChangedRows.Num() > 0 || RemovedRows.Num() > 0))
+	{
+		const FScopedTransaction Transaction(LOCTEXT("ImportDataTableRows", "Import DataTable Rows"));
+		FDataTableEditorUtils::BroadcastPreChange(DataTable, FDataTableEditorUtils::EDataTableChangeInfo::RowList);
+		DataTable->Modify();
+
+		for (const FName RowName : RemovedRows)
+		{
+			DataTable->RemoveRow(RowName);
+		}
+
+		TArray<FString> ImportProblems;
+		for (const TPair<int32, TUniquePtr<FStructOnScope>>& ChangedRow : ChangedRows)
+		{
+			const FName RowName = File.Rows[ChangedRow.Key].Name;
+			const uint8* ScratchData = ChangedRow.Value->GetStructMemory();
+			if (uint8* ExistingRow = ExistingRows[ChangedRow.Key])
+			{
+				RowStruct->CopyScriptStruct(ExistingRow, ScratchData);
+			}
+			else
+			{
+				DataTable->AddRow(RowName, *reinterpret_cast<const FTableRowBase*>(ScratchData));
+			}
+
+			if (FTableRowBase* TableRow = reinterpret_cast<FTableRowBase*>(DataTable->FindRowUnchecked(RowName)))
+			{
+				TableRow->OnPostDataImport(DataTable, RowName, ImportProblems);
+			}
+		}
+		for (const FString& Problem : ImportProblems)
+		{
+			UE_LOG(LogRedDataTable, Warning, TEXT("%s"), *Problem);
+		}
+
+		FDataTableEditorUtils::BroadcastPostChange(DataTable, FDataTableEditorUtils::EDataTableChangeInfo::RowList);
+		DataTable->MarkPackageDirty();
+	}
+
+	OutStats.Seconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogRedDataTable, Display,
+	       TEXT("%s '%s' into '%s': %d added, %d updated, %d removed, %d unchanged, %d failed in %.2fs."),
+	       Options.bDryRun ? TEXT("Checked importing") : TEXT("Imported"), *Filename, *DataTable->GetPathName(),
+	       OutStats.NumAdded, OutStats.NumUpdated, OutStats.NumRemoved, OutStats.NumUnchanged, OutStats.NumFailed,
+	       OutStats.Seconds);
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,414 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedEditorIconIndex.h"
+
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
+#include "RedDeveloperSettings.h"
+#include "Brushes/SlateDynamicImageBrush.h"
+#include "Brushes/SlateImageBrush.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "Styling/SlateStyle.h"
+#include "Styling/SlateStyleRegistry.h"
+
+namespace RedEditorIconIndex
+{
+	/** Turns an engine relative icon path into a short category label, e.g. "Editor/Starship/Common". */
+	FString MakeCategory(const FString& InPath, const FString& ItemName)
+	{
+		const int EngineIndex = InPath.Find(TEXT("/Engine/"));
+		const int EditorIndex = InPath.Find(TEXT("/Editor/"));
+		int RightChopIndex = 0;
+		if (EngineIndex >= 0 || EditorIndex >= 0)
+		{
+			RightChopIndex = FMath::Max(EngineIndex + 7, EditorIndex + 7);
+		}
+
+		return InPath.RightChop(RightChopIndex).LeftChop(ItemName.Len() + 1).
+		              Replace(TEXT("/Content/"),TEXT("/")).
+		              Replace(TEXT("/Slate/"),TEXT("/")).
+		              Replace(TEXT("/Plugins/"),TEXT("/")).
+		              Replace(TEXT("/Experimental/"),TEXT("/")).RightChop(1);
+	}
+
+	TUniquePtr<FRedEditorIconIndex> Instance;
+
+	ERedEditorIconFileType GetFileType(const FString& InPath)
+	{
+		const FString Ext = FPaths::GetExtension(InPath);
+		if (Ext == TEXT("svg"))
+		{
+			return ERedEditorIconFileType::Svg;
+		}
+		if (Ext == TEXT("png"))
+		{
+			return ERedEditorIconFileType::Png;
+		}
+		return ERedEditorIconFileType::Unsupported;
+	}
+}
+
+FRedEditorIconEntry::FRedEditorIconEntry(const FString& InPath, const bool bInExists)
+	: Path(MakeShared<FString>(InPath))
+	, bExists(bInExists)
+{
+	const FString ItemName = FPaths::GetCleanFilename(InPath);
+	AbsolutePath = FPaths::ConvertRelativePathToFull(InPath);
+	DisplayName = FText::FromString(ItemName);
+	Category = FText::FromString(RedEditorIconIndex::MakeCategory(InPath, ItemName));
+	FileType = RedEditorIconIndex::GetFileType(InPath);
+}
+
+FRedEditorStyleIconEntry::FRedEditorStyleIconEntry(const FName InStyleSetName, const FName InStyleName)
+	: Key(MakeShared<FString>(FString::Printf(TEXT("%s::%s"), *InStyleSetName.ToString(), *InStyleName.ToString())))
+	, StyleSetName(InStyleSetName)
+	, StyleName(InStyleName)
+	, DisplayName(FText::FromName(InStyleName))
+	, Category(FText::FromName(InStyleSetName))
+{
+}
+
+FRedEditorIconIndex& FRedEditorIconIndex::Get()
+{
+	if (!RedEditorIconIndex::Instance.IsValid())
+	{
+		RedEditorIconIndex::Instance = MakeUnique<FRedEditorIconIndex>();
+	}
+	return *RedEditorIconIndex::Instance;
+}
+
+void FRedEditorIconIndex::Shutdown()
+{
+	RedEditorIconIndex::Instance.Reset();
+}
+
+FRedEditorIconIndex::~FRedEditorIconIndex()
+{
+	UnwatchDirectories();
+}
+
+TArray<TSharedPtr<FString>>* FRedEditorIconIndex::GetOptionsSource()
+{
+	if (!bIsBuilt)
+	{
+		BuildIndex();
+	}
+	return &Options;
+}
+
+TSharedPtr<const FRedEditorIconEntry> FRedEditorIconIndex::FindEntry(const FString& InPath)
+{
+	if (!bIsBuilt)
+	{
+		BuildIndex();
+	}
+
+	if (const TSharedRef<FRedEditorIconEntry>* Entry = Entries.Find(InPath))
+	{
+		return *Entry;
+	}
+	return nullptr;
+}
+
+bool FRedEditorIconIndex::DoesIconExist(const FString& InPath)
+{
+	if (InPath.IsEmpty())
+	{
+		return false;
+	}
+
+	if (const TSharedPtr<const FRedEditorIconEntry> Entry = FindEntry(InPath))
+	{
+		return Entry->bExists;
+	}
+
+	// Only found files are remembered. Unindexed paths aren't watched, so a missing file may be created at any time.
+	if (UnindexedIcons.Contains(InPath))
+	{
+		return true;
+	}
+	if (!IFileManager::Get().FileExists(*FPaths::ConvertRelativePathToFull(InPath)))
+	{
+		return false;
+	}
+	UnindexedIcons.Add(InPath);
+	return true;
+}
+
+TSharedPtr<FSlateBrush> FRedEditorIconIndex::GetPreviewBrush(const FRedEditorIconEntry& Entry)
+{
+	static FVector2D IconSize = FVector2D(24, 24);
+
+	TSharedPtr<FSlateBrush>& Brush = PreviewBrushes.FindOrAdd(*Entry.Path);
+	if (!Brush.IsValid())
+	{
+		if (Entry.FileType == ERedEditorIconFileType::Svg)
+		{
+			Brush = MakeShared<FSlateVectorImageBrush>(*Entry.Path, IconSize);
+		}
+		else if (Entry.FileType == ERedEditorIconFileType::Png)
+		{
+			Brush = MakeShared<FSlateDynamicImageBrush>(FName(**Entry.Path), IconSize);
+		}
+	}
+	return Brush;
+}
+
+TArray<TSharedPtr<FString>>* FRedEditorIconIndex::GetStyleOptionsSource()
+{
+	TSet<FName> RegisteredStyleSets;
+	FSlateStyleRegistry::IterateAllStyles([&RegisteredStyleSets](const ISlateStyle& Style)
+	{
+		RegisteredStyleSets.Add(Style.GetStyleSetName());
+		return true;
+	});
+
+	if (StyleOptions.Num() == 0 || !RegisteredStyleSets.Includes(IndexedStyleSets)
+		|| !IndexedStyleSets.Includes(RegisteredStyleSets))
+	{
+		BuildStyleIndex();
+	}
+	return &StyleOptions;
+}
+
+TSharedPtr<const FRedEditorStyleIconEntry> FRedEditorIconIndex::FindStyleEntry(const FString& InKey) const
+{
+	if (const TSharedRef<FRedEditorStyleIconEntry>* Entry = StyleEntries.Find(InKey))
+	{
+		return *Entry;
+	}
+	return nullptr;
+}
+
+void FRedEditorIconIndex::BuildStyleIndex()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedEditorIconIndex::BuildStyleIndex);
+
+	StyleOptions.Reset();
+	StyleEntries.Reset();
+	IndexedStyleSets.Reset();
+
+	FSlateStyleRegistry::IterateAllStyles([this](const ISlateStyle& Style)
+	{
+		IndexedStyleSets.Add(Style.GetStyleSetName());
+		for (const FName& StyleName : Style.GetStyleKeys())
+		{
+			// Only plain images make sense as icons, skip boxes, borders and anything without a resource.
+			const FSlateBrush* Brush = Style.GetOptionalBrush(StyleName, nullptr, nullptr);
+			if (Brush == nullptr || Brush->GetDrawType() != ESlateBrushDrawType::Image
+				|| Brush->GetImageType() == ESlateBrushImageType::NoImage)
+			{
+				continue;
+			}
+
+			TSharedRef<FRedEditorStyleIconEntry> Entry = MakeShared<FRedEditorStyleIconEntry>(
+				Style.GetStyleSetName(), StyleName);
+			StyleOptions.Add(Entry->Key);
+			StyleEntries.Add(*Entry->Key, Entry);
+		}
+		return true;
+	});
+}
+
+void FRedEditorIconIndex::BuildIndex()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedEditorIconIndex::BuildIndex);
+
+	bIsBuilt = true;
+	Options.Reset();
+	Entries.Reset();
+	PreviewBrushes.Reset();
+	UnindexedIcons.Reset();
+
+	TArray<FString> FoundIcons;
+	const URedDeveloperSettings* RedSettings = GetDefault<URedDeveloperSettings>();
+	for (const FString& Path : RedSettings->EditorIconWidgetSearchPaths)
+	{
+		GetIconsFromPath(Path, FoundIcons);
+	}
+
+	Options.Reserve(FoundIcons.Num());
+	Entries.Reserve(FoundIcons.Num());
+	for (const FString& Icon : FoundIcons)
+	{
+		AddEntry(Icon);
+	}
+
+	WatchDirectories();
+}
+
+void FRedEditorIconIndex::AddEntry(const FString& InPath)
+{
+	if (Entries.Contains(InPath))
+	{
+		return;
+	}
+
+	// Everything FindFilesRecursive or the DirectoryWatcher reports as added exists, no need to stat it again.
+	TSharedRef<FRedEditorIconEntry> Entry = MakeShared<FRedEditorIconEntry>(InPath, true);
+	Options.Add(Entry->Path);
+	Entries.Add(InPath, Entry);
+}
+
+void FRedEditorIconIndex::RemoveEntry(const FString& InPath)
+{
+	if (const TSharedRef<FRedEditorIconEntry>* Entry = Entries.Find(InPath))
+	{
+		Options.Remove((*Entry)->Path);
+		Entries.Remove(InPath);
+	}
+
+	// Rows that are still on screen hold their own reference to the brush, so this only drops the index's copy.
+	PreviewBrushes.Remove(InPath);
+}
+
+void FRedEditorIconIndex::WatchDirectories()
+{
+	UnwatchDirectories();
+
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(
+		TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get();
+	if (DirectoryWatcher == nullptr)
+	{
+		return;
+	}
+
+	const URedDeveloperSettings* RedSettings = GetDefault<URedDeveloperSettings>();
+	for (const FString& Path : RedSettings->EditorIconWidgetSearchPaths)
+	{
+		FWatchedDirectory& Watched = WatchedDirectories.AddDefaulted_GetRef();
+		Watched.SearchPath = Path;
+		Watched.Directory = FPaths::EngineDir() / Path;
+		Watched.AbsoluteDirectory = FPaths::ConvertRelativePathToFull(Watched.Directory);
+		FPaths::NormalizeDirectoryName(Watched.AbsoluteDirectory);
+
+		const int32 WatchedDirectoryIndex = WatchedDirectories.Num() - 1;
+		DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(
+			Watched.AbsoluteDirectory,
+			IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FRedEditorIconIndex::HandleDirectoryChanged,
+			                                                WatchedDirectoryIndex),
+			Watched.Handle);
+	}
+}
+
+void FRedEditorIconIndex::UnwatchDirectories()
+{
+	if (FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(
+		TEXT("DirectoryWatcher")))
+	{
+		if (IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule->Get())
+		{
+			for (const FWatchedDirectory& Watched : WatchedDirectories)
+			{
+				DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(Watched.AbsoluteDirectory, Watched.Handle);
+			}
+		}
+	}
+	WatchedDirectories.Reset();
+}
+
+void FRedEditorIconIndex::HandleDirectoryChanged(const TArray<FFileChangeData>& FileChanges,
+                                                 const int32 WatchedDirectoryIndex)
+{
+	if (!WatchedDirectories.IsValidIndex(WatchedDirectoryIndex))
+	{
+		return;
+	}
+
+	const FWatchedDirectory& Watched = WatchedDirectories[WatchedDirectoryIndex];
+	bool bChanged = false;
+	for (const FFileChangeData& FileChange : FileChanges)
+	{
+		if (FileChange.Action == FFileChangeData::FCA_RescanRequired)
+		{
+			// The OS dropped events for this directory, so only this directory is scanned again.
+			TArray<FString> FoundIcons;
+			GetIconsFromPath(Watched.SearchPath, FoundIcons);
+			const TSet<FString> FoundIconSet(FoundIcons);
+			TArray<FString> StaleIcons;
+			for (const TPair<FString, TSharedRef<FRedEditorIconEntry>>& Pair : Entries)
+			{
+				if (Pair.Key.StartsWith(Watched.Directory) && !FoundIconSet.Contains(Pair.Key))
+				{
+					StaleIcons.Add(Pair.Key);
+				}
+			}
+			for (const FString& Icon : StaleIcons)
+			{
+				RemoveEntry(Icon);
+			}
+			for (const FString& Icon : FoundIcons)
+			{
+				AddEntry(Icon);
+			}
+			bChanged = true;
+			continue;
+		}
+
+		FString Filename = FileChange.Filename;
+		FPaths::NormalizeFilename(Filename);
+		if (RedEditorIconIndex::GetFileType(Filename) == ERedEditorIconFileType::Unsupported
+			|| !Filename.StartsWith(Watched.AbsoluteDirectory))
+		{
+			continue;
+		}
+
+		// Map the absolute path back into the same form FindFilesRecursive produced when the index was built.
+		const FString Path = Watched.Directory / Filename.RightChop(Watched.AbsoluteDirectory.Len() + 1);
+		switch (FileChange.Action)
+		{
+		case FFileChangeData::FCA_Added:
+			AddEntry(Path);
+			break;
+		case FFileChangeData::FCA_Modified:
+			// The entry itself is still valid, only the decoded image is out of date.
+			if (const TSharedRef<FRedEditorIconEntry>* Entry = Entries.Find(Path))
+			{
+				++(*Entry)->Revision;
+			}
+			PreviewBrushes.Remove(Path);
+			break;
+		case FFileChangeData::FCA_Removed:
+			RemoveEntry(Path);
+			break;
+		default:
+			continue;
+		}
+		bChanged = true;
+	}
+
+	if (bChanged)
+	{
+		IndexChangedEvent.Broadcast();
+	}
+}
+
+void FRedEditorIconIndex::GetIconsFromPath(const FString& InPath, TArray<FString>& OutFoundIcons)
+{
+	const FString SearchDirectory = FPaths::EngineDir() / InPath;
+	IFileManager::Get().FindFilesRecursive(OutFoundIcons, *SearchDirectory, TEXT("*.png"), true, false, false);
+	IFileManager::Get().FindFilesRecursive(OutFoundIcons, *SearchDirectory, TEXT("*.svg"), true, false, false);
+}
@@ -22,35 +22,93 @@
 
 #include "RedEditorIconWidget.h"
 
+#include "RedEditorIconIndex.h"
 #include "Brushes/SlateImageBrush.h"
 #include "Components/Image.h"
-#include "HAL/FileManager.h"
 #include "Misc/EngineVersion.h"
+#include "Styling/SlateStyleRegistry.h"
+
+const FSlateBrush* FRedEditorIconPath::FindStyleBrush() const
+{
+	if (const ISlateStyle* Style = FSlateStyleRegistry::FindSlateStyle(StyleSetName))
+	{
+		return Style->GetOptionalBrush(StyleName, nullptr, nullptr);
+	}
+	return nullptr;
+}
 
 void URedEditorIconWidget::SynchronizeProperties()
 {
 	Super::SynchronizeProperties();
 
+	if (IconPath.Source == ERedEditorIconSource::SlateStyle)
+	{
+		// Draw the style's own brush rather than a copy of it, so nothing new is loaded and theme changes show up.
+		// It is looked up by name on every paint, the brush goes away if its style set is unregistered.
+		if (IconPath.FindStyleBrush() != nullptr && MyImage.IsValid())
+		{
+			MyImage->SetImage(TAttribute<const FSlateBrush*>::CreateLambda([StylePath = IconPath]()
+			{
+				return StylePath.FindStyleBrush();
+			}));
+			MyImage->SetDesiredSizeOverride(IconSize);
+			bBoundToStyleBrush = true;
+		}
+		return;
+	}
+
+	if (bBoundToStyleBrush)
+	{
+		// Super has already pointed the image back at Brush, just make sure the file brush gets rebuilt.
+		if (MyImage.IsValid())
+		{
+			MyImage->SetDesiredSizeOverride(TOptional<FVector2D>());
+		}
+		IconBrushKey = FIconBrushKey();
+		bBoundToStyleBrush = false;
+	}
+
 #if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION > 1
 	const FSlateBrush& BrushRef = GetBrush();
 #else
 	const FSlateBrush& BrushRef = Brush;
 #endif
 
-	if (!IconPath.Path.IsEmpty() && IFileManager::Get().FileExists(*FPaths::ConvertRelativePathToFull(*IconPath.Path)))
+	FRedEditorIconIndex& IconIndex = FRedEditorIconIndex::Get();
+	if (!IconIndex.DoesIconExist(IconPath.Path))
 	{
-		if (const FString Ext = FPaths::GetExtension(IconPath.Path); Ext == "svg")
-		{
-			IconBrush.Reset(new FSlateVectorImageBrush(IconPath.Path, IconSize, BrushRef.TintColor, BrushRef.Tiling));
-		}
-		else if (Ext == "png")
-		{
-			IconBrush.Reset(new FSlateDynamicImageBrush(FName(*IconPath.Path), IconSize,
-			                                            BrushRef.TintColor.GetSpecifiedColor(), BrushRef.Tiling));
-		}
-		if (IconBrush != nullptr)
-		{
-			SetBrush(*IconBrush.Get());
-		}
+		return;
+	}
+
+	FIconBrushKey NewKey;
+	NewKey.Path = IconPath.Path;
+	NewKey.Size = IconSize;
+	NewKey.TintColor = BrushRef.TintColor;
+	NewKey.Tiling = BrushRef.Tiling;
+	if (const TSharedPtr<const FRedEditorIconEntry> Entry = IconIndex.FindEntry(IconPath.Path))
+	{
+		NewKey.Entry = Entry;
+		NewKey.Revision = Entry->Revision;
+	}
+
+	// UMG calls this on every designer refresh and property change, only decode the image again when it can differ.
+	if (IconBrush.IsValid() && NewKey == IconBrushKey)
+	{
+		return;
+	}
+
+	if (const FString Ext = FPaths::GetExtension(IconPath.Path); Ext == "svg")
+	{
+		IconBrush.Reset(new FSlateVectorImageBrush(IconPath.Path, IconSize, BrushRef.TintColor, BrushRef.Tiling));
+	}
+	else if (Ext == "png")
+	{
+		IconBrush.Reset(new FSlateDynamicImageBrush(FName(*IconPath.Path), IconSize,
+		                                            BrushRef.TintColor.GetSpecifiedColor(), BrushRef.Tiling));
+	}
+	if (IconBrush != nullptr)
+	{
+		IconBrushKey = MoveTemp(NewKey);
+		SetBrush(*IconBrush.Get());
 	}
 }
@@ -0,0 +1,212 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedMaterialEditBatch.h"
+
+#include "RedMaterialParameterPreview.h"
+#include "Editor.h"
+#include "EditorSupportDelegates.h"
+#include "MaterialEditingLibrary.h"
+#include "MaterialShared.h"
+#include "ShaderCompiler.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialExpression.h"
+#include "Materials/MaterialFunction.h"
+#include "UObject/UObjectIterator.h"
+
+namespace RedMaterialEditBatch
+{
+	FRedMaterialEditBatch* ActiveBatch = nullptr;
+}
+
+// Edits made during a preview aren't transacted, the preview commits them in a batch of its own when it ends.
+FRedMaterialEditBatch::FRedMaterialEditBatch(const FText& Description)
+	: Transaction(Description, FRedMaterialParameterPreview::GetActive() == nullptr)
+	, PreviousActive(RedMaterialEditBatch::ActiveBatch)
+{
+	RedMaterialEditBatch::ActiveBatch = this;
+}
+
+FRedMaterialEditBatch::~FRedMaterialEditBatch()
+{
+	Finish();
+}
+
+int32 FRedMaterialEditBatch::Finish(const bool bWaitForCompilation)
+{
+	if (bFinished)
+	{
+		return 0;
+	}
+	bFinished = true;
+
+	check(RedMaterialEditBatch::ActiveBatch == this);
+	RedMaterialEditBatch::ActiveBatch = PreviousActive;
+
+	if (PreviousActive != nullptr)
+	{
+		MergeInto(*PreviousActive);
+		return 0;
+	}
+	return UpdateDirtyObjects(bWaitForCompilation);
+}
+
+FRedMaterialEditBatch* FRedMaterialEditBatch::GetActive()
+{
+	return RedMaterialEditBatch::ActiveBatch;
+}
+
+void FRedMaterialEditBatch::ModifyExpression(UMaterialExpression* Expression)
+{
+	if (!IsValid(Expression))
+	{
+		return;
+	}
+
+	if (FRedMaterialParameterPreview* Preview = FRedMaterialParameterPreview::GetActive())
+	{
+		Preview->RecordExpression(Expression);
+	}
+	else if (FRedMaterialEditBatch* Batch = GetActive())
+	{
+		Batch->RecordExpression(Expression);
+	}
+	else
+	{
+		Expression->Modify();
+	}
+}
+
+void FRedMaterialEditBatch::RecordExpression(UMaterialExpression* Expression)
+{
+	bool bAlreadyModified = false;
+	ModifiedExpressions.Add(Expression, &bAlreadyModified);
+	if (bAlreadyModified)
+	{
+		return;
+	}
+
+	Expression->Modify();
+	if (UMaterialFunctionInterface* Function = Expression->Function; IsValid(Function))
+	{
+		if (!DirtyFunctions.Contains(Function))
+		{
+			Function->Modify();
+			DirtyFunctions.Add(Function);
+		}
+	}
+	else if (UMaterial* Material = Expression->Material; IsValid(Material))
+	{
+		if (!DirtyMaterials.Contains(Material))
+		{
+			Material->Modify();
+			DirtyMaterials.Add(Material);
+		}
+	}
+}
+
+void FRedMaterialEditBatch::MergeInto(FRedMaterialEditBatch& Outer)
+{
+	Outer.ModifiedExpressions.Append(ModifiedExpressions);
+	Outer.DirtyMaterials.Append(DirtyMaterials);
+	Outer.DirtyFunctions.Append(DirtyFunctions);
+}
+
+int32 FRedMaterialEditBatch::UpdateDirtyObjects(const bool bWaitForCompilation)
+{
+	if (DirtyMaterials.Num() == 0 && DirtyFunctions.Num() == 0)
+	{
+		return 0;
+	}
+
+	TSet<UMaterial*> MaterialsToRecompile;
+	for (const TWeakObjectPtr<UMaterial>& Material : DirtyMaterials)
+	{
+		if (Material.IsValid())
+		{
+			MaterialsToRecompile.Add(Material.Get());
+		}
+	}
+
+	TSet<UMaterialFunctionInterface*> Functions;
+	for (const TWeakObjectPtr<UMaterialFunctionInterface>& Function : DirtyFunctions)
+	{
+		if (Function.IsValid())
+		{
+			Function->PreEditChange(nullptr);
+			Function->PostEditChange();
+			Function->MarkPackageDirty();
+			Functions.Add(Function.Get());
+		}
+	}
+
+	// One pass over the loaded materials for all of the edited functions, rather than one pass per function.
+	if (Functions.Num() > 0)
+	{
+		for (TObjectIterator<UMaterial> It; It; ++It)
+		{
+			UMaterial* Material = *It;
+			if (MaterialsToRecompile.Contains(Material))
+			{
+				continue;
+			}
+			for (const FMaterialFunctionInfo& FunctionInfo : Material->GetCachedExpressionData().FunctionInfos)
+			{
+				if (Functions.Contains(FunctionInfo.Function))
+				{
+					MaterialsToRecompile.Add(Material);
+					break;
+				}
+			}
+		}
+	}
+
+	{
+		FMaterialUpdateContext UpdateContext;
+		for (UMaterial* Material : MaterialsToRecompile)
+		{
+			UpdateContext.AddMaterial(Material);
+			Material->PreEditChange(nullptr);
+			Material->PostEditChange();
+			Material->MarkPackageDirty();
+		}
+	}
+
+	for (UMaterial* Material : MaterialsToRecompile)
+	{
+		UMaterialEditingLibrary::RebuildMaterialInstanceEditors(Material);
+	}
+	for (UMaterialFunctionInterface* Function : Functions)
+	{
+		UMaterialEditingLibrary::RebuildMaterialInstanceEditors(Function->GetBaseFunction());
+	}
+
+	FEditorDelegates::RefreshEditor.Broadcast();
+	FEditorSupportDelegates::RedrawAllViewports.Broadcast();
+
+	if (bWaitForCompilation && GShaderCompilingManager != nullptr)
+	{
+		GShaderCompilingManager->FinishAllCompilation();
+	}
+
+	return MaterialsToRecompile.Num();
+}
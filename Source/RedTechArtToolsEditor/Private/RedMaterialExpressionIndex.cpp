@@ -0,0 +1,600 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedMaterialExpressionIndex.h"
+
+#include "RedAssetRegistryTagWriter.h"
+#include "Algo/AllOf.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/ParallelFor.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialExpressionCollectionParameter.h"
+#include "Materials/MaterialExpressionComment.h"
+#include "Materials/MaterialExpressionMaterialFunctionCall.h"
+#include "Materials/MaterialExpressionTextureBase.h"
+#include "Materials/MaterialFunction.h"
+
+const FName FRedMaterialExpressionIndex::ExpressionsTagName = FName("RedMaterialExpressions");
+
+namespace RedMaterialExpressionIndex
+{
+	TUniquePtr<FRedMaterialExpressionIndex> Instance;
+	FDelegateHandle TagWriterHandle;
+
+	/*
+	 * Tag format: one expression per line, fields separated by tabs.
+	 *	Class	Name	ExpressionGuid	Description	ParameterName	ReferenceType	ReferencedAsset
+	 * Readers ignore any fields past the ones they know about, so more can be appended later.
+	 */
+	constexpr TCHAR FieldSeparator = TEXT('\t');
+	constexpr TCHAR RowSeparator = TEXT('\n');
+	constexpr int32 NumFields = 7;
+
+	const FName TextureReferenceType("Texture");
+	const FName FunctionReferenceType("Function");
+	const FName CollectionReferenceType("Collection");
+
+	FString SanitizeField(FString Field)
+	{
+		Field.ReplaceCharInline(FieldSeparator, TEXT(' '));
+		Field.ReplaceCharInline(RowSeparator, TEXT(' '));
+		Field.ReplaceCharInline(TEXT('\r'), TEXT(' '));
+		return Field;
+	}
+
+	TConstArrayView<TObjectPtr<UMaterialExpression>> GetExpressions(const UObject* MaterialOrFunction)
+	{
+		if (const UMaterial* Material = Cast<UMaterial>(MaterialOrFunction))
+		{
+			return Material->GetExpressions();
+		}
+		if (const UMaterialFunction* Function = Cast<UMaterialFunction>(MaterialOrFunction))
+		{
+			return Function->GetExpressions();
+		}
+		return {};
+	}
+
+	FString GetExpressionClassName(const UClass* Class)
+	{
+		FString Name = Class->GetName();
+		Name.RemoveFromStart(TEXT("MaterialExpression"));
+		return Name;
+	}
+
+	void GetReferencedAsset(const UMaterialExpression* Expression, FName& OutType, FString& OutPath)
+	{
+		const UObject* Referenced = nullptr;
+		if (const auto* TextureExpression = Cast<UMaterialExpressionTextureBase>(Expression))
+		{
+			Referenced = TextureExpression->Texture;
+			OutType = TextureReferenceType;
+		}
+		else if (const auto* FunctionCall = Cast<UMaterialExpressionMaterialFunctionCall>(Expression))
+		{
+			Referenced = FunctionCall->MaterialFunction;
+			OutType = FunctionReferenceType;
+		}
+		else if (const auto* CollectionParameter = Cast<UMaterialExpressionCollectionParameter>(Expression))
+		{
+			Referenced = CollectionParameter->Collection;
+			OutType = CollectionReferenceType;
+		}
+
+		if (Referenced == nullptr)
+		{
+			OutType = NAME_None;
+			OutPath.Reset();
+			return;
+		}
+		OutPath = Referenced->GetPathName();
+	}
+
+	enum class EQueryKey : uint8
+	{
+		Any,
+		Class,
+		Name,
+		Description,
+		Texture,
+		Function,
+		Collection,
+		Reference,
+		Asset
+	};
+
+	struct FQueryTerm
+	{
+		EQueryKey Key = EQueryKey::Any;
+		FString Pattern;
+		bool bExclude = false;
+	};
+
+	bool ParseKey(const FStringView Key, EQueryKey& OutKey)
+	{
+		static const TPair<const TCHAR*, EQueryKey> Keys[] = {
+			{TEXT("class"), EQueryKey::Class},
+			{TEXT("name"), EQueryKey::Name},
+			{TEXT("desc"), EQueryKey::Description},
+			{TEXT("texture"), EQueryKey::Texture},
+			{TEXT("function"), EQueryKey::Function},
+			{TEXT("collection"), EQueryKey::Collection},
+			{TEXT("ref"), EQueryKey::Reference},
+			{TEXT("asset"), EQueryKey::Asset},
+		};
+		for (const TPair<const TCHAR*, EQueryKey>& Pair : Keys)
+		{
+			if (Key.Equals(Pair.Key, ESearchCase::IgnoreCase))
+			{
+				OutKey = Pair.Value;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	TArray<FQueryTerm> ParseQuery(const FString& Query)
+	{
+		TArray<FQueryTerm> Terms;
+		int32 Index = 0;
+		while (Index < Query.Len())
+		{
+			if (FChar::IsWhitespace(Query[Index]))
+			{
+				++Index;
+				continue;
+			}
+
+			FQueryTerm Term;
+			if (Query[Index] == TEXT('-'))
+			{
+				Term.bExclude = true;
+				++Index;
+			}
+
+			// Read up to the end of the term, quoted text can contain spaces.
+			FString Text;
+			bool bInQuotes = false;
+			int32 KeyEnd = INDEX_NONE;
+			for (; Index < Query.Len() && (bInQuotes || !FChar::IsWhitespace(Query[Index])); ++Index)
+			{
+				const TCHAR Char = Query[Index];
+				if (Char == TEXT('"'))
+				{
+					bInQuotes = !bInQuotes;
+				}
+				else if (Char == TEXT(':') && !bInQuotes && KeyEnd == INDEX_NONE)
+				{
+					KeyEnd = Text.Len();
+					Text.AppendChar(Char);
+				}
+				else
+				{
+					Text.AppendChar(Char);
+				}
+			}
+
+			EQueryKey Key;
+			if (KeyEnd != INDEX_NONE && ParseKey(FStringView(Text).Left(KeyEnd), Key))
+			{
+				Term.Key = Key;
+				Term.Pattern = Text.RightChop(KeyEnd + 1);
+			}
+			else
+			{
+				Term.Pattern = MoveTemp(Text);
+			}
+
+			// Free text matches anywhere, unless the pattern says otherwise.
+			if ((Term.Key == EQueryKey::Any || Term.Key == EQueryKey::Description)
+				&& !Term.Pattern.Contains(TEXT("*")) && !Term.Pattern.Contains(TEXT("?")))
+			{
+				Term.Pattern = TEXT("*") + Term.Pattern + TEXT("*");
+			}
+
+			if (!Term.Pattern.IsEmpty())
+			{
+				Terms.Add(MoveTemp(Term));
+			}
+		}
+		return Terms;
+	}
+
+	bool MatchesText(const FString& Text, const FString& Pattern)
+	{
+		return Text.MatchesWildcard(Pattern, ESearchCase::IgnoreCase);
+	}
+
+	bool MatchesAsset(const FSoftObjectPath& Asset, const FString& Pattern)
+	{
+		return !Asset.IsNull() && (MatchesText(Asset.GetAssetName(), Pattern) || MatchesText(Asset.ToString(), Pattern));
+	}
+
+	bool MatchesReference(const FRedIndexedMaterialExpression& Expression, const FName Type, const FString& Pattern)
+	{
+		return (Type.IsNone() || Expression.ReferenceType == Type) && MatchesAsset(Expression.ReferencedAsset, Pattern);
+	}
+
+	bool Matches(const FRedIndexedMaterialExpression& Expression, const FQueryTerm& Term)
+	{
+		switch (Term.Key)
+		{
+		case EQueryKey::Class:
+			return MatchesText(Expression.ExpressionClass.ToString(), Term.Pattern)
+				|| MatchesText(TEXT("MaterialExpression") + Expression.ExpressionClass.ToString(), Term.Pattern);
+		case EQueryKey::Name:
+			return !Expression.ParameterName.IsNone() && MatchesText(Expression.ParameterName.ToString(), Term.Pattern);
+		case EQueryKey::Description:
+			return MatchesText(Expression.Description, Term.Pattern);
+		case EQueryKey::Texture:
+			return MatchesReference(Expression, TextureReferenceType, Term.Pattern);
+		case EQueryKey::Function:
+			return MatchesReference(Expression, FunctionReferenceType, Term.Pattern);
+		case EQueryKey::Collection:
+			return MatchesReference(Expression, CollectionReferenceType, Term.Pattern);
+		case EQueryKey::Reference:
+			return MatchesReference(Expression, NAME_None, Term.Pattern);
+		case EQueryKey::Asset:
+			return MatchesAsset(Expression.Asset, Term.Pattern);
+		default:
+			return MatchesText(Expression.ExpressionClass.ToString(), Term.Pattern)
+				|| MatchesText(Expression.Description, Term.Pattern)
+				|| (!Expression.ParameterName.IsNone() && MatchesText(Expression.ParameterName.ToString(), Term.Pattern));
+		}
+	}
+}
+
+FRedMaterialExpressionIndex& FRedMaterialExpressionIndex::Get()
+{
+	if (!RedMaterialExpressionIndex::Instance.IsValid())
+	{
+		RedMaterialExpressionIndex::Instance = MakeUnique<FRedMaterialExpressionIndex>();
+	}
+	return *RedMaterialExpressionIndex::Instance;
+}
+
+void FRedMaterialExpressionIndex::RegisterTagWriter()
+{
+	RedMaterialExpressionIndex::TagWriterHandle = FRedAssetRegistryTagWriter::Register(
+		ExpressionsTagName,
+		[](const UObject* Object) { return Object->IsA<UMaterial>() || Object->IsA<UMaterialFunction>(); },
+		&FRedMaterialExpressionIndex::MakeExpressionsTagValue);
+}
+
+void FRedMaterialExpressionIndex::Shutdown()
+{
+	FRedAssetRegistryTagWriter::Unregister(RedMaterialExpressionIndex::TagWriterHandle);
+	RedMaterialExpressionIndex::Instance.Reset();
+}
+
+FRedMaterialExpressionIndex::~FRedMaterialExpressionIndex()
+{
+	if (IAssetRegistry* AssetRegistry = IAssetRegistry::Get())
+	{
+		AssetRegistry->OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry->OnAssetUpdated().Remove(AssetUpdatedHandle);
+		AssetRegistry->OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry->OnAssetRenamed().Remove(AssetRenamedHandle);
+		AssetRegistry->OnFilesLoaded().Remove(FilesLoadedHandle);
+	}
+}
+
+TArray<FRedIndexedMaterialExpression> FRedMaterialExpressionIndex::Find(const FString& Query)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialExpressionIndex::Find);
+	using namespace RedMaterialExpressionIndex;
+
+	if (!bIsBuilt)
+	{
+		BuildIndex();
+	}
+
+	const TArray<FQueryTerm> Terms = ParseQuery(Query);
+	if (Terms.Num() == 0)
+	{
+		return {};
+	}
+
+	TArray<const TArray<FRedIndexedMaterialExpression>*> AssetExpressions;
+	AssetExpressions.Reserve(ExpressionsByAsset.Num());
+	for (const TPair<FSoftObjectPath, TArray<FRedIndexedMaterialExpression>>& Pair : ExpressionsByAsset)
+	{
+		AssetExpressions.Add(&Pair.Value);
+	}
+
+	// Each asset is matched on its own, then the results are joined in asset order.
+	TArray<TArray<FRedIndexedMaterialExpression>> AssetMatches;
+	AssetMatches.SetNum(AssetExpressions.Num());
+	ParallelFor(AssetExpressions.Num(), [&](const int32 AssetIndex)
+	{
+		for (const FRedIndexedMaterialExpression& Expression : *AssetExpressions[AssetIndex])
+		{
+			const bool bMatches = Algo::AllOf(Terms, [&Expression](const FQueryTerm& Term)
+			{
+				return Matches(Expression, Term) != Term.bExclude;
+			});
+			if (bMatches)
+			{
+				AssetMatches[AssetIndex].Add(Expression);
+			}
+		}
+	});
+
+	TArray<FRedIndexedMaterialExpression> Result;
+	for (TArray<FRedIndexedMaterialExpression>& Matched : AssetMatches)
+	{
+		Result.Append(MoveTemp(Matched));
+	}
+	return Result;
+}
+
+bool FRedMaterialExpressionIndex::GetAssetExpressions(const FSoftObjectPath& Asset,
+                                                     TArray<FRedIndexedMaterialExpression>& OutExpressions)
+{
+	if (!bIsBuilt)
+	{
+		BuildIndex();
+	}
+
+	const TArray<FRedIndexedMaterialExpression>* Expressions = ExpressionsByAsset.Find(Asset);
+	if (Expressions == nullptr)
+	{
+		return false;
+	}
+	OutExpressions.Append(*Expressions);
+	return true;
+}
+
+TArray<FSoftObjectPath> FRedMaterialExpressionIndex::GetUnindexedAssets()
+{
+	if (!bIsBuilt)
+	{
+		BuildIndex();
+	}
+	return UnindexedAssets.Array();
+}
+
+UMaterialExpression* FRedMaterialExpressionIndex::ResolveExpression(const FRedIndexedMaterialExpression& Expression)
+{
+	const UObject* Asset = Expression.Asset.TryLoad();
+	UMaterialExpression* ByName = nullptr;
+	for (UMaterialExpression* Candidate : RedMaterialExpressionIndex::GetExpressions(Asset))
+	{
+		if (Candidate == nullptr)
+		{
+			continue;
+		}
+		if (Expression.ExpressionGuid.IsValid() && Candidate->MaterialExpressionGuid == Expression.ExpressionGuid)
+		{
+			return Candidate;
+		}
+		if (Candidate->GetFName() == Expression.ExpressionName)
+		{
+			ByName = Candidate;
+		}
+	}
+
+	// The guid can change if the asset was edited since it was indexed, the object name usually doesn't.
+	return ByName;
+}
+
+FString FRedMaterialExpressionIndex::MakeExpressionsTagValue(const UObject* MaterialOrFunction)
+{
+	using namespace RedMaterialExpressionIndex;
+
+	TStringBuilder<4096> Builder;
+	FName ReferenceType;
+	FString ReferencedAsset;
+	for (const UMaterialExpression* Expression : GetExpressions(MaterialOrFunction))
+	{
+		if (Expression == nullptr)
+		{
+			continue;
+		}
+
+		const FString& Description = Expression->IsA<UMaterialExpressionComment>()
+			                             ? CastChecked<UMaterialExpressionComment>(Expression)->Text
+			                             : Expression->Desc;
+		const FName ParameterName = (Expression->bIsParameterExpression
+			                             || Expression->IsA<UMaterialExpressionCollectionParameter>())
+			                            ? Expression->GetParameterName()
+			                            : NAME_None;
+		GetReferencedAsset(Expression, ReferenceType, ReferencedAsset);
+
+		Builder << GetExpressionClassName(Expression->GetClass()) << FieldSeparator
+			<< Expression->GetName() << FieldSeparator
+			<< Expression->MaterialExpressionGuid.ToString(EGuidFormats::Digits) << FieldSeparator
+			<< SanitizeField(Description) << FieldSeparator
+			<< (ParameterName.IsNone() ? FString() : SanitizeField(ParameterName.ToString())) << FieldSeparator
+			<< (ReferenceType.IsNone() ? FString() : ReferenceType.ToString()) << FieldSeparator
+			<< ReferencedAsset << RowSeparator;
+	}
+	return Builder.ToString();
+}
+
+void FRedMaterialExpressionIndex::ParseExpressionsTagValue(const FSoftObjectPath& Asset, const FStringView TagValue,
+                                                           TArray<FRedIndexedMaterialExpression>& OutExpressions)
+{
+	using namespace RedMaterialExpressionIndex;
+
+	TArray<FStringView, TInlineAllocator<NumFields + 1>> Fields;
+	FStringView Remaining = TagValue;
+	while (!Remaining.IsEmpty())
+	{
+		int32 RowEnd = INDEX_NONE;
+		if (!Remaining.FindChar(RowSeparator, RowEnd))
+		{
+			RowEnd = Remaining.Len();
+		}
+		const FStringView Row = Remaining.Left(RowEnd);
+		Remaining.RightChopInline(RowEnd + 1);
+
+		Fields.Reset();
+		FStringView RowRemaining = Row;
+		while (true)
+		{
+			int32 FieldEnd = INDEX_NONE;
+			if (!RowRemaining.FindChar(FieldSeparator, FieldEnd))
+			{
+				Fields.Add(RowRemaining);
+				break;
+			}
+			Fields.Add(RowRemaining.Left(FieldEnd));
+			RowRemaining.RightChopInline(FieldEnd + 1);
+		}
+
+		if (Fields.Num() < NumFields)
+		{
+			continue;
+		}
+
+		FRedIndexedMaterialExpression& Expression = OutExpressions.AddDefaulted_GetRef();
+		Expression.Asset = Asset;
+		Expression.ExpressionClass = FName(Fields[0]);
+		Expression.ExpressionName = FName(Fields[1]);
+		FGuid::Parse(FString(Fields[2]), Expression.ExpressionGuid);
+		Expression.Description = FString(Fields[3]);
+		Expression.ParameterName = Fields[4].IsEmpty() ? NAME_None : FName(Fields[4]);
+		Expression.ReferenceType = Fields[5].IsEmpty() ? NAME_None : FName(Fields[5]);
+		if (!Fields[6].IsEmpty())
+		{
+			Expression.ReferencedAsset = FSoftObjectPath(FString(Fields[6]));
+		}
+	}
+}
+
+void FRedMaterialExpressionIndex::BuildIndex()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialExpressionIndex::BuildIndex);
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	if (!bIsBuilt)
+	{
+		AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(
+			this, &FRedMaterialExpressionIndex::HandleAssetAddedOrUpdated);
+		AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(
+			this, &FRedMaterialExpressionIndex::HandleAssetAddedOrUpdated);
+		AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(
+			this, &FRedMaterialExpressionIndex::HandleAssetRemoved);
+		AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(
+			this, &FRedMaterialExpressionIndex::HandleAssetRenamed);
+		if (AssetRegistry.IsLoadingAssets())
+		{
+			// Build from what is known now, and again once the initial scan has found everything.
+			FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(
+				this, &FRedMaterialExpressionIndex::HandleFilesLoaded);
+		}
+	}
+	bIsBuilt = true;
+
+	ExpressionsByAsset.Reset();
+	UnindexedAssets.Reset();
+
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UMaterial::StaticClass()->GetClassPathName());
+	Filter.ClassPaths.Add(UMaterialFunction::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+
+	// Tags are read on the game thread, the much larger job of parsing them runs in parallel.
+	TArray<TPair<FSoftObjectPath, FString>> TaggedAssets;
+	AssetRegistry.EnumerateAssets(Filter, [this, &TaggedAssets](const FAssetData& AssetData)
+	{
+		FString TagValue;
+		if (AssetData.GetTagValue(ExpressionsTagName, TagValue))
+		{
+			TaggedAssets.Emplace(AssetData.GetSoftObjectPath(), MoveTemp(TagValue));
+		}
+		else
+		{
+			UnindexedAssets.Add(AssetData.GetSoftObjectPath());
+		}
+		return true;
+	});
+
+	TArray<TArray<FRedIndexedMaterialExpression>> ParsedExpressions;
+	ParsedExpressions.SetNum(TaggedAssets.Num());
+	ParallelFor(TaggedAssets.Num(), [&TaggedAssets, &ParsedExpressions](const int32 Index)
+	{
+		ParseExpressionsTagValue(TaggedAssets[Index].Key, TaggedAssets[Index].Value, ParsedExpressions[Index]);
+	});
+
+	ExpressionsByAsset.Reserve(TaggedAssets.Num());
+	for (int32 Index = 0; Index < TaggedAssets.Num(); ++Index)
+	{
+		ExpressionsByAsset.Add(TaggedAssets[Index].Key, MoveTemp(ParsedExpressions[Index]));
+	}
+}
+
+void FRedMaterialExpressionIndex::AddAsset(const FAssetData& AssetData)
+{
+	const FSoftObjectPath Asset = AssetData.GetSoftObjectPath();
+	ExpressionsByAsset.Remove(Asset);
+	UnindexedAssets.Remove(Asset);
+
+	FString TagValue;
+	if (!AssetData.GetTagValue(ExpressionsTagName, TagValue))
+	{
+		UnindexedAssets.Add(Asset);
+		return;
+	}
+	ParseExpressionsTagValue(Asset, TagValue, ExpressionsByAsset.Add(Asset));
+}
+
+void FRedMaterialExpressionIndex::HandleAssetAddedOrUpdated(const FAssetData& AssetData)
+{
+	const UClass* AssetClass = AssetData.GetClass();
+	if (bIsBuilt && AssetClass != nullptr
+		&& (AssetClass->IsChildOf<UMaterial>() || AssetClass->IsChildOf<UMaterialFunction>()))
+	{
+		AddAsset(AssetData);
+	}
+}
+
+void FRedMaterialExpressionIndex::HandleAssetRemoved(const FAssetData& AssetData)
+{
+	if (bIsBuilt)
+	{
+		ExpressionsByAsset.Remove(AssetData.GetSoftObjectPath());
+		UnindexedAssets.Remove(AssetData.GetSoftObjectPath());
+	}
+}
+
+void FRedMaterialExpressionIndex::HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	if (bIsBuilt)
+	{
+		ExpressionsByAsset.Remove(FSoftObjectPath(OldObjectPath));
+		UnindexedAssets.Remove(FSoftObjectPath(OldObjectPath));
+		HandleAssetAddedOrUpdated(AssetData);
+	}
+}
+
+void FRedMaterialExpressionIndex::HandleFilesLoaded()
+{
+	if (IAssetRegistry* AssetRegistry = IAssetRegistry::Get())
+	{
+		AssetRegistry->OnFilesLoaded().Remove(FilesLoadedHandle);
+	}
+	FilesLoadedHandle.Reset();
+	BuildIndex();
+}
@@ -0,0 +1,523 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedMaterialInstanceHierarchy.h"
+
+#include "RedMaterialParameterBlueprintLibrary.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "FileHelpers.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialFunction.h"
+#include "Materials/MaterialInstanceConstant.h"
+#include "Materials/MaterialLayersFunctions.h"
+#include "Misc/PackageName.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace RedMaterialInstanceHierarchy
+{
+	IAssetRegistry& GetAssetRegistry()
+	{
+		return FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	}
+
+	/** True if the function is the given one, an instance of it, or calls it somewhere inside. */
+	bool UsesFunction(const UMaterialFunctionInterface* Function, const UMaterialFunctionInterface* Target)
+	{
+		if (Function == nullptr || Target == nullptr)
+		{
+			return false;
+		}
+		const UMaterialFunction* TargetBase = Target->GetBaseFunction();
+		if (Function == Target || Function->GetBaseFunction() == TargetBase)
+		{
+			return true;
+		}
+		TArray<UMaterialFunctionInterface*> Dependencies;
+		Function->GetDependentFunctions(Dependencies);
+		return Dependencies.ContainsByPredicate([Target, TargetBase](const UMaterialFunctionInterface* Dependency)
+		{
+			return Dependency == Target || (Dependency != nullptr && Dependency->GetBaseFunction() == TargetBase);
+		});
+	}
+
+	/**
+	 * Which of an instance's overrides refer to the renamed parameter. Global overrides match by name, layer and
+	 * blend overrides only if the layer or blend at their index is, or uses, the function the parameter is in.
+	 */
+	struct FRenameFilter
+	{
+		FRenameFilter(const UMaterialInstanceConstant* Instance, const FName InOldName,
+		              const UMaterialFunctionInterface* OwningFunction)
+			: OldName(InOldName)
+		{
+			FMaterialLayersFunctions Layers;
+			if (OwningFunction == nullptr || !Instance->GetMaterialLayers(Layers))
+			{
+				return;
+			}
+			for (const UMaterialFunctionInterface* Layer : Layers.Layers)
+			{
+				RenamedLayers.Add(UsesFunction(Layer, OwningFunction));
+			}
+			for (const UMaterialFunctionInterface* Blend : Layers.Blends)
+			{
+				RenamedBlends.Add(UsesFunction(Blend, OwningFunction));
+			}
+		}
+
+		bool ShouldRename(const FMaterialParameterInfo& ParameterInfo) const
+		{
+			if (ParameterInfo.Name != OldName)
+			{
+				return false;
+			}
+			switch (ParameterInfo.Association)
+			{
+			case EMaterialParameterAssociation::GlobalParameter:
+				return true;
+			case EMaterialParameterAssociation::LayerParameter:
+				return RenamedLayers.IsValidIndex(ParameterInfo.Index) && RenamedLayers[ParameterInfo.Index];
+			case EMaterialParameterAssociation::BlendParameter:
+				return RenamedBlends.IsValidIndex(ParameterInfo.Index) && RenamedBlends[ParameterInfo.Index];
+			default:
+				return false;
+			}
+		}
+
+		FName OldName;
+		TBitArray<> RenamedLayers;
+		TBitArray<> RenamedBlends;
+	};
+
+	/**
+	 * Renames matching entries in one of the instance's parameter arrays. An entry is left alone if the instance
+	 * already has an entry with the new name, the instance would end up with two overrides of the same parameter.
+	 */
+	template <typename TParameterValue>
+	bool RenameEntries(TArray<TParameterValue>& Values, const FRenameFilter& Filter, const FName NewName,
+	                   const UObject* Instance)
+	{
+		bool bRenamed = false;
+		for (TParameterValue& Value : Values)
+		{
+			if (!Filter.ShouldRename(Value.ParameterInfo))
+			{
+				continue;
+			}
+
+			FMaterialParameterInfo NewInfo = Value.ParameterInfo;
+			NewInfo.Name = NewName;
+			if (Values.ContainsByPredicate([&NewInfo](const TParameterValue& Other)
+			{
+				return Other.ParameterInfo == NewInfo;
+			}))
+			{
+				UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning,
+				       TEXT("'%s' already overrides '%s', leaving its override of '%s' as it is."),
+				       *Instance->GetPathName(), *NewName.ToString(), *Filter.OldName.ToString());
+				continue;
+			}
+
+			Value.ParameterInfo = NewInfo;
+			bRenamed = true;
+		}
+		return bRenamed;
+	}
+
+	FMaterialParameterValue GetOverrideValue(const FScalarParameterValue& Override)
+	{
+		return FMaterialParameterValue(Override.ParameterValue);
+	}
+
+	FMaterialParameterValue GetOverrideValue(const FVectorParameterValue& Override)
+	{
+		return FMaterialParameterValue(Override.ParameterValue);
+	}
+
+	FMaterialParameterValue GetOverrideValue(const FDoubleVectorParameterValue& Override)
+	{
+		return FMaterialParameterValue(Override.ParameterValue);
+	}
+
+	FMaterialParameterValue GetOverrideValue(const FTextureParameterValue& Override)
+	{
+		return FMaterialParameterValue(ToRawPtr(Override.ParameterValue));
+	}
+
+	FMaterialParameterValue GetOverrideValue(const FRuntimeVirtualTextureParameterValue& Override)
+	{
+		return FMaterialParameterValue(ToRawPtr(Override.ParameterValue));
+	}
+
+	FMaterialParameterValue GetOverrideValue(const FFontParameterValue& Override)
+	{
+		return FMaterialParameterValue(ToRawPtr(Override.FontValue), Override.FontPage);
+	}
+
+	FMaterialParameterValue GetOverrideValue(const FStaticSwitchParameter& Override)
+	{
+		return FMaterialParameterValue(Override.Value);
+	}
+
+	FMaterialParameterValue GetOverrideValue(const FStaticComponentMaskParameter& Override)
+	{
+		return FMaterialParameterValue(Override.R, Override.G, Override.B, Override.A);
+	}
+
+	template <typename TParameterValue>
+	bool IsInherited(const TParameterValue& Override, UMaterialInterface* Parent, const EMaterialParameterType Type)
+	{
+		FMaterialParameterMetadata Inherited;
+		return Parent->GetParameterValue(Type, Override.ParameterInfo, Inherited)
+			&& Inherited.Value == GetOverrideValue(Override);
+	}
+
+	/** Removes the overrides that match the parent's value, returns how many were removed. */
+	template <typename TParameterValue>
+	int32 PruneValues(TArray<TParameterValue>& Values, UMaterialInterface* Parent, const EMaterialParameterType Type)
+	{
+		return Values.RemoveAll([Parent, Type](const TParameterValue& Override)
+		{
+			return IsInherited(Override, Parent, Type);
+		});
+	}
+
+	/** Static overrides stay in the set, they are switched off instead. Returns how many were switched off. */
+	template <typename TStaticParameter>
+	int32 PruneStatics(TArray<TStaticParameter>& Statics, UMaterialInterface* Parent, const EMaterialParameterType Type)
+	{
+		int32 NumPruned = 0;
+		for (TStaticParameter& Override : Statics)
+		{
+			if (Override.bOverride && IsInherited(Override, Parent, Type))
+			{
+				Override.bOverride = false;
+				++NumPruned;
+			}
+		}
+		return NumPruned;
+	}
+
+	template <typename TStaticParameter>
+	bool HasOverride(const TArray<TStaticParameter>& Statics)
+	{
+		return Statics.ContainsByPredicate([](const TStaticParameter& Override) { return Override.bOverride; });
+	}
+}
+
+void FRedMaterialInstanceHierarchy::FindAssetsUsingFunction(const FSoftObjectPath& MaterialFunction,
+                                                            TArray<FSoftObjectPath>& OutMaterials,
+                                                            TArray<FSoftObjectPath>& OutInstances)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialInstanceHierarchy::FindAssetsUsingFunction);
+
+	IAssetRegistry& AssetRegistry = RedMaterialInstanceHierarchy::GetAssetRegistry();
+
+	// Functions can be nested, so follow referencing functions until only materials and instances are left.
+	TArray<FName> PendingPackages = {MaterialFunction.GetLongPackageFName()};
+	TSet<FName> VisitedPackages(PendingPackages);
+	TArray<FName> Referencers;
+	TArray<FAssetData> ReferencerAssets;
+	while (PendingPackages.Num() > 0)
+	{
+		Referencers.Reset();
+		AssetRegistry.GetReferencers(PendingPackages.Pop(), Referencers,
+		                             UE::AssetRegistry::EDependencyCategory::Package);
+		for (const FName Referencer : Referencers)
+		{
+			bool bAlreadyVisited = false;
+			VisitedPackages.Add(Referencer, &bAlreadyVisited);
+			if (bAlreadyVisited)
+			{
+				continue;
+			}
+
+			ReferencerAssets.Reset();
+			AssetRegistry.GetAssetsByPackageName(Referencer, ReferencerAssets);
+			for (const FAssetData& AssetData : ReferencerAssets)
+			{
+				const UClass* AssetClass = AssetData.GetClass();
+				if (AssetClass == nullptr)
+				{
+					continue;
+				}
+				if (AssetClass->IsChildOf<UMaterial>())
+				{
+					OutMaterials.Add(AssetData.GetSoftObjectPath());
+				}
+				else if (AssetClass->IsChildOf<UMaterialInstanceConstant>())
+				{
+					OutInstances.Add(AssetData.GetSoftObjectPath());
+				}
+				else if (AssetClass->IsChildOf<UMaterialFunctionInterface>())
+				{
+					PendingPackages.Add(Referencer);
+				}
+			}
+		}
+	}
+}
+
+TArray<FSoftObjectPath> FRedMaterialInstanceHierarchy::FindDescendantInstances(
+	TConstArrayView<FSoftObjectPath> Parents)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialInstanceHierarchy::FindDescendantInstances);
+
+	// One pass over the instances builds the whole parent to children map, then the tree is walked from the roots.
+	TMultiMap<FSoftObjectPath, FSoftObjectPath> ChildrenByParent;
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UMaterialInstanceConstant::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	IAssetRegistry& AssetRegistry = RedMaterialInstanceHierarchy::GetAssetRegistry();
+	AssetRegistry.EnumerateAssets(Filter, [&ChildrenByParent](const FAssetData& AssetData)
+	{
+		FString ParentPath;
+		if (AssetData.GetTagValue(FName("Parent"), ParentPath))
+		{
+			const FSoftObjectPath Parent(FPackageName::ExportTextPathToObjectPath(ParentPath));
+			if (Parent.IsValid())
+			{
+				ChildrenByParent.Add(Parent, AssetData.GetSoftObjectPath());
+			}
+		}
+		return true;
+	});
+
+	// Breadth first, so every instance is listed after its parent.
+	TArray<FSoftObjectPath> Hierarchy(Parents);
+	TSet<FSoftObjectPath> Visited(Parents);
+	TArray<FSoftObjectPath> Children;
+	for (int32 Index = 0; Index < Hierarchy.Num(); ++Index)
+	{
+		Children.Reset();
+		ChildrenByParent.MultiFind(Hierarchy[Index], Children);
+		for (const FSoftObjectPath& Child : Children)
+		{
+			bool bAlreadyVisited = false;
+			Visited.Add(Child, &bAlreadyVisited);
+			if (!bAlreadyVisited)
+			{
+				Hierarchy.Add(Child);
+			}
+		}
+	}
+	Hierarchy.RemoveAt(0, Parents.Num());
+	return Hierarchy;
+}
+
+void FRedMaterialInstanceHierarchy::LoadInBatches(TConstArrayView<FSoftObjectPath> Assets, const int32 BatchSize,
+                                                  const bool bCollectGarbage,
+                                                  TFunctionRef<void(TConstArrayView<UObject*>)> Visitor)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialInstanceHierarchy::LoadInBatches);
+
+	TArray<UObject*> Objects;
+	const int32 ClampedBatchSize = FMath::Max(BatchSize, 1);
+	for (int32 BatchStart = 0; BatchStart < Assets.Num(); BatchStart += ClampedBatchSize)
+	{
+		const TConstArrayView<FSoftObjectPath> Batch =
+			Assets.Slice(BatchStart, FMath::Min(ClampedBatchSize, Assets.Num() - BatchStart));
+		for (const FSoftObjectPath& Asset : Batch)
+		{
+			if (Asset.ResolveObject() == nullptr)
+			{
+				LoadPackageAsync(Asset.GetLongPackageName());
+			}
+		}
+		FlushAsyncLoading();
+
+		Objects.Reset();
+		for (const FSoftObjectPath& Asset : Batch)
+		{
+			if (UObject* Object = Asset.ResolveObject())
+			{
+				Objects.Add(Object);
+			}
+			else
+			{
+				UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning, TEXT("Failed to load '%s'."), *Asset.ToString());
+			}
+		}
+
+		Visitor(Objects);
+
+		if (bCollectGarbage)
+		{
+			Objects.Reset();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+	}
+}
+
+int32 FRedMaterialInstanceHierarchy::SavePackages(const TArray<UPackage*>& Packages)
+{
+	if (Packages.Num() == 0 || UEditorLoadingAndSavingUtils::SavePackages(Packages, true))
+	{
+		return 0;
+	}
+
+	// Packages that saved are no longer dirty.
+	int32 NumFailed = 0;
+	for (const UPackage* Package : Packages)
+	{
+		if (Package->IsDirty())
+		{
+			UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Error, TEXT("Failed to save '%s'."), *Package->GetName());
+			++NumFailed;
+		}
+	}
+	return NumFailed;
+}
+
+bool FRedMaterialInstanceHierarchy::RenameParameterOverrides(UMaterialInstanceConstant* Instance, const FName OldName,
+                                                             const FName NewName,
+                                                             const UMaterialFunctionInterface* OwningFunction)
+{
+	using namespace RedMaterialInstanceHierarchy;
+
+	if (!IsValid(Instance) || OldName == NewName)
+	{
+		return false;
+	}
+
+	// Renamed on copies first, so an instance with nothing to rename isn't dirtied.
+	TArray<FScalarParameterValue> ScalarValues = Instance->ScalarParameterValues;
+	TArray<FVectorParameterValue> VectorValues = Instance->VectorParameterValues;
+	TArray<FDoubleVectorParameterValue> DoubleVectorValues = Instance->DoubleVectorParameterValues;
+	TArray<FTextureParameterValue> TextureValues = Instance->TextureParameterValues;
+	TArray<FRuntimeVirtualTextureParameterValue> RuntimeVirtualTextureValues =
+		Instance->RuntimeVirtualTextureParameterValues;
+	TArray<FFontParameterValue> FontValues = Instance->FontParameterValues;
+	FStaticParameterSet StaticParameters = Instance->GetStaticParameters();
+
+	const FRenameFilter Filter(Instance, OldName, OwningFunction);
+	bool bRenamedValues = false;
+	bRenamedValues |= RenameEntries(ScalarValues, Filter, NewName, Instance);
+	bRenamedValues |= RenameEntries(VectorValues, Filter, NewName, Instance);
+	bRenamedValues |= RenameEntries(DoubleVectorValues, Filter, NewName, Instance);
+	bRenamedValues |= RenameEntries(TextureValues, Filter, NewName, Instance);
+	bRenamedValues |= RenameEntries(RuntimeVirtualTextureValues, Filter, NewName, Instance);
+	bRenamedValues |= RenameEntries(FontValues, Filter, NewName, Instance);
+
+	bool bRenamedStatics = false;
+	bRenamedStatics |= RenameEntries(StaticParameters.StaticSwitchParameters, Filter, NewName, Instance);
+	bRenamedStatics |= RenameEntries(StaticParameters.EditorOnly.StaticComponentMaskParameters, Filter, NewName,
+	                                 Instance);
+
+	if (!bRenamedValues && !bRenamedStatics)
+	{
+		return false;
+	}
+
+	Instance->PreEditChange(nullptr);
+	Instance->Modify();
+	if (bRenamedValues)
+	{
+		Instance->ScalarParameterValues = MoveTemp(ScalarValues);
+		Instance->VectorParameterValues = MoveTemp(VectorValues);
+		Instance->DoubleVectorParameterValues = MoveTemp(DoubleVectorValues);
+		Instance->TextureParameterValues = MoveTemp(TextureValues);
+		Instance->RuntimeVirtualTextureParameterValues = MoveTemp(RuntimeVirtualTextureValues);
+		Instance->FontParameterValues = MoveTemp(FontValues);
+	}
+	if (bRenamedStatics)
+	{
+		Instance->UpdateStaticPermutation(StaticParameters);
+	}
+	Instance->PostEditChange();
+	return true;
+}
+
+bool FRedMaterialInstanceHierarchy::PruneRedundantOverrides(UMaterialInstanceConstant* Instance, const bool bDryRun,
+                                                            FRedMaterialOverridePruneReport& Report)
+{
+	using namespace RedMaterialInstanceHierarchy;
+
+	UMaterialInterface* Parent = IsValid(Instance) ? Instance->Parent.Get() : nullptr;
+	if (Parent == nullptr)
+	{
+		return false;
+	}
+	++Report.NumInstancesVisited;
+
+	TArray<FScalarParameterValue> ScalarValues = Instance->ScalarParameterValues;
+	TArray<FVectorParameterValue> VectorValues = Instance->VectorParameterValues;
+	TArray<FDoubleVectorParameterValue> DoubleVectorValues = Instance->DoubleVectorParameterValues;
+	TArray<FTextureParameterValue> TextureValues = Instance->TextureParameterValues;
+	TArray<FRuntimeVirtualTextureParameterValue> RuntimeVirtualTextureValues =
+		Instance->RuntimeVirtualTextureParameterValues;
+	TArray<FFontParameterValue> FontValues = Instance->FontParameterValues;
+	FStaticParameterSet StaticParameters = Instance->GetStaticParameters();
+
+	int32 NumPruned = 0;
+	NumPruned += PruneValues(ScalarValues, Parent, EMaterialParameterType::Scalar);
+	NumPruned += PruneValues(VectorValues, Parent, EMaterialParameterType::Vector);
+	NumPruned += PruneValues(DoubleVectorValues, Parent, EMaterialParameterType::DoubleVector);
+	NumPruned += PruneValues(TextureValues, Parent, EMaterialParameterType::Texture);
+	NumPruned += PruneValues(RuntimeVirtualTextureValues, Parent, EMaterialParameterType::RuntimeVirtualTexture);
+	NumPruned += PruneValues(FontValues, Parent, EMaterialParameterType::Font);
+
+	int32 NumStaticsPruned = 0;
+	NumStaticsPruned += PruneStatics(StaticParameters.StaticSwitchParameters, Parent,
+	                                 EMaterialParameterType::StaticSwitch);
+	NumStaticsPruned += PruneStatics(StaticParameters.EditorOnly.StaticComponentMaskParameters, Parent,
+	                                 EMaterialParameterType::StaticComponentMask);
+
+	if (NumPruned == 0 && NumStaticsPruned == 0)
+	{
+		return false;
+	}
+
+	Report.NumInstancesChanged++;
+	Report.NumOverridesRemoved += NumPruned;
+	Report.NumStaticOverridesRemoved += NumStaticsPruned;
+	Report.ChangedInstances.Add(FSoftObjectPath(Instance));
+
+	const bool bHadStaticPermutation = Instance->bHasStaticPermutationResource;
+	if (bDryRun)
+	{
+		// Same rule the instance uses when its static permutation is updated.
+		const bool bKeepsStaticPermutation = HasOverride(StaticParameters.StaticSwitchParameters)
+			|| HasOverride(StaticParameters.EditorOnly.StaticComponentMaskParameters)
+			|| Instance->HasOverridenBaseProperties();
+		Report.NumShaderPermutationsRemoved += bHadStaticPermutation && !bKeepsStaticPermutation ? 1 : 0;
+		return true;
+	}
+
+	Instance->PreEditChange(nullptr);
+	Instance->Modify();
+	Instance->ScalarParameterValues = MoveTemp(ScalarValues);
+	Instance->VectorParameterValues = MoveTemp(VectorValues);
+	Instance->DoubleVectorParameterValues = MoveTemp(DoubleVectorValues);
+	Instance->TextureParameterValues = MoveTemp(TextureValues);
+	Instance->RuntimeVirtualTextureParameterValues = MoveTemp(RuntimeVirtualTextureValues);
+	Instance->FontParameterValues = MoveTemp(FontValues);
+	if (NumStaticsPruned > 0)
+	{
+		Instance->UpdateStaticPermutation(StaticParameters);
+	}
+	Instance->PostEditChange();
+
+	Report.NumShaderPermutationsRemoved += bHadStaticPermutation && !Instance->bHasStaticPermutationResource ? 1 : 0;
+	return true;
+}
@@ -0,0 +1,637 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedMaterialParameterAudit.h"
+
+#include "RedMaterialParameterBlueprintLibrary.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialFunction.h"
+#include "Misc/Crc.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY(LogRedMaterialParameterAudit);
+
+namespace RedMaterialParameterAudit
+{
+	/** Column indices, in file order. Each index is the bit of its ERedMaterialParameterAuditColumns flag. */
+	enum EColumn : int32
+	{
+		Column_Asset,
+		Column_AssetClass,
+		Column_ParameterName,
+		Column_Type,
+		Column_Group,
+		Column_SortPriority,
+		Column_Description,
+		Column_ScalarMin,
+		Column_ScalarMax,
+		Column_ExpressionGuid,
+		Column_Num
+	};
+
+	const TCHAR* ColumnNames[Column_Num] = {
+		TEXT("Asset"),
+		TEXT("AssetClass"),
+		TEXT("ParameterName"),
+		TEXT("Type"),
+		TEXT("Group"),
+		TEXT("SortPriority"),
+		TEXT("Description"),
+		TEXT("ScalarMin"),
+		TEXT("ScalarMax"),
+		TEXT("ExpressionGuid"),
+	};
+
+	ERedMaterialParameterAuditColumns GetColumnFlag(const int32 ColumnIndex)
+	{
+		return static_cast<ERedMaterialParameterAuditColumns>(1 << ColumnIndex);
+	}
+
+	FString MakeCsvHeader()
+	{
+		return FString::Join(ColumnNames, TEXT(",")) + TEXT("\n");
+	}
+
+	FString EscapeCsvField(const FString& Field)
+	{
+		int32 Index;
+		if (!Field.FindChar(TEXT(','), Index) && !Field.FindChar(TEXT('"'), Index)
+			&& !Field.FindChar(TEXT('\n'), Index) && !Field.FindChar(TEXT('\r'), Index))
+		{
+			return Field;
+		}
+		return TEXT("\"") + Field.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+	}
+
+	/** Splits a CSV record into fields, returns false if a quoted field isn't closed. */
+	bool ParseCsvRecord(const FStringView Record, TArray<FString>& OutFields)
+	{
+		OutFields.Reset();
+		FString Field;
+		bool bInQuotes = false;
+		for (int32 Index = 0; Index < Record.Len(); ++Index)
+		{
+			const TCHAR Char = Record[Index];
+			if (bInQuotes)
+			{
+				if (Char == TEXT('"'))
+				{
+					if (Index + 1 < Record.Len() && Record[Index + 1] == TEXT('"'))
+					{
+						Field.AppendChar(TEXT('"'));
+						++Index;
+					}
+					else
+					{
+						bInQuotes = false;
+					}
+				}
+				else
+				{
+					Field.AppendChar(Char);
+				}
+			}
+			else if (Char == TEXT('"'))
+			{
+				bInQuotes = true;
+			}
+			else if (Char == TEXT(','))
+			{
+				OutFields.Add(MoveTemp(Field));
+				Field.Reset();
+			}
+			else if (Char != TEXT('\r'))
+			{
+				Field.AppendChar(Char);
+			}
+		}
+		OutFields.Add(MoveTemp(Field));
+		return !bInQuotes;
+	}
+
+	// Floats are written with enough digits to read back the exact same value, so an unchanged file diffs clean.
+	FString FormatCsvRow(const FRedMaterialParameterAuditRow& Row)
+	{
+		return FString::Printf(TEXT("%s,%s,%s,%s,%s,%d,%s,%.9g,%.9g,%s\n"),
+		                       *EscapeCsvField(Row.Asset),
+		                       *Row.AssetClass.ToString(),
+		                       *EscapeCsvField(Row.ParameterName.ToString()),
+		                       *Row.TypeName.ToString(),
+		                       *EscapeCsvField(Row.Group.ToString()),
+		                       Row.SortPriority,
+		                       *EscapeCsvField(Row.Description),
+		                       Row.ScalarMin,
+		                       Row.ScalarMax,
+		                       *Row.ExpressionGuid.ToString(EGuidFormats::DigitsWithHyphens));
+	}
+
+	FString FormatJsonRow(const FRedMaterialParameterAuditRow& Row)
+	{
+		FString Json;
+		const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter =
+			TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json);
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(ColumnNames[Column_Asset], Row.Asset);
+		JsonWriter->WriteValue(ColumnNames[Column_AssetClass], Row.AssetClass.ToString());
+		JsonWriter->WriteValue(ColumnNames[Column_ParameterName], Row.ParameterName.ToString());
+		JsonWriter->WriteValue(ColumnNames[Column_Type], Row.TypeName.ToString());
+		JsonWriter->WriteValue(ColumnNames[Column_Group], Row.Group.ToString());
+		JsonWriter->WriteValue(ColumnNames[Column_SortPriority], Row.SortPriority);
+		JsonWriter->WriteValue(ColumnNames[Column_Description], Row.Description);
+		JsonWriter->WriteValue(ColumnNames[Column_ScalarMin], Row.ScalarMin);
+		JsonWriter->WriteValue(ColumnNames[Column_ScalarMax], Row.ScalarMax);
+		JsonWriter->WriteValue(ColumnNames[Column_ExpressionGuid],
+		                       Row.ExpressionGuid.ToString(EGuidFormats::DigitsWithHyphens));
+		JsonWriter->WriteObjectEnd();
+		JsonWriter->Close();
+		return Json;
+	}
+
+	/** Sets a row field from its text form, returns false if the value doesn't parse. */
+	bool SetRowField(FRedMaterialParameterAuditRow& Row, const int32 ColumnIndex, const FString& Value)
+	{
+		switch (ColumnIndex)
+		{
+		case Column_Asset:
+			Row.Asset = Value;
+			return true;
+		case Column_AssetClass:
+			Row.AssetClass = FName(Value);
+			return true;
+		case Column_ParameterName:
+			Row.ParameterName = FName(Value);
+			return true;
+		case Column_Type:
+			Row.TypeName = FName(Value);
+			return true;
+		case Column_Group:
+			Row.Group = FName(Value);
+			return true;
+		case Column_SortPriority:
+			return LexTryParseString(Row.SortPriority, *Value);
+		case Column_Description:
+			Row.Description = Value;
+			return true;
+		case Column_ScalarMin:
+			return LexTryParseString(Row.ScalarMin, *Value);
+		case Column_ScalarMax:
+			return LexTryParseString(Row.ScalarMax, *Value);
+		case Column_ExpressionGuid:
+			return FGuid::Parse(Value, Row.ExpressionGuid);
+		default:
+			return false;
+		}
+	}
+
+	bool ParseJsonRow(const FStringView Line, FRedMaterialParameterAuditRow& OutRow,
+	                  ERedMaterialParameterAuditColumns& OutColumns)
+	{
+		TSharedPtr<FJsonObject> Object;
+		const TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(FString(Line));
+		if (!FJsonSerializer::Deserialize(JsonReader, Object) || !Object.IsValid())
+		{
+			return false;
+		}
+
+		OutColumns = ERedMaterialParameterAuditColumns::None;
+		for (int32 ColumnIndex = 0; ColumnIndex < Column_Num; ++ColumnIndex)
+		{
+			const TSharedPtr<FJsonValue> Value = Object->TryGetField(ColumnNames[ColumnIndex]);
+			if (!Value.IsValid())
+			{
+				continue;
+			}
+
+			// Numbers are read directly, going through a string would lose precision.
+			bool bParsed = true;
+			double Number;
+			if (ColumnIndex == Column_SortPriority && Value->TryGetNumber(Number))
+			{
+				OutRow.SortPriority = static_cast<int32>(Number);
+			}
+			else if (ColumnIndex == Column_ScalarMin && Value->TryGetNumber(Number))
+			{
+				OutRow.ScalarMin = static_cast<float>(Number);
+			}
+			else if (ColumnIndex == Column_ScalarMax && Value->TryGetNumber(Number))
+			{
+				OutRow.ScalarMax = static_cast<float>(Number);
+			}
+			else
+			{
+				bParsed = SetRowField(OutRow, ColumnIndex, Value->AsString());
+			}
+
+			if (!bParsed)
+			{
+				return false;
+			}
+			OutColumns |= GetColumnFlag(ColumnIndex);
+		}
+		return true;
+	}
+}
+
+TUniquePtr<FRedMaterialParameterAuditWriter> FRedMaterialParameterAuditWriter::Create(
+	const FString& Filename, const ERedMaterialParameterAuditFormat Format)
+{
+	TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Archive)
+	{
+		UE_LOG(LogRedMaterialParameterAudit, Error, TEXT("Could not open '%s' for writing."), *Filename);
+		return nullptr;
+	}
+	return TUniquePtr<FRedMaterialParameterAuditWriter>(new FRedMaterialParameterAuditWriter(MoveTemp(Archive), Format));
+}
+
+ERedMaterialParameterAuditFormat FRedMaterialParameterAuditWriter::GetFormatFromFilename(const FString& Filename)
+{
+	const FString Extension = FPaths::GetExtension(Filename);
+	if (Extension.Equals(TEXT("json"), ESearchCase::IgnoreCase))
+	{
+		return ERedMaterialParameterAuditFormat::Json;
+	}
+	if (Extension.Equals(TEXT("jsonl"), ESearchCase::IgnoreCase))
+	{
+		return ERedMaterialParameterAuditFormat::JsonLines;
+	}
+	return ERedMaterialParameterAuditFormat::Csv;
+}
+
+FRedMaterialParameterAuditWriter::FRedMaterialParameterAuditWriter(TUniquePtr<FArchive>&& InArchive,
+                                                                   const ERedMaterialParameterAuditFormat InFormat)
+	: Archive(MoveTemp(InArchive)), Format(InFormat)
+{
+	if (Format == ERedMaterialParameterAuditFormat::Json)
+	{
+		WriteString(TEXT("["));
+	}
+	else if (Format == ERedMaterialParameterAuditFormat::Csv)
+	{
+		WriteString(RedMaterialParameterAudit::MakeCsvHeader());
+	}
+}
+
+FRedMaterialParameterAuditWriter::~FRedMaterialParameterAuditWriter()
+{
+	Close();
+}
+
+void FRedMaterialParameterAuditWriter::Write(TConstArrayView<FRedMaterialParameterAuditRow> Rows)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialParameterAuditWriter::Write);
+
+	if (!Archive || Rows.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FString> Lines;
+	Lines.SetNum(Rows.Num());
+	const int32 FirstRowIndex = NumWrittenRows;
+	ParallelFor(Rows.Num(), [&](const int32 Index)
+	{
+		switch (Format)
+		{
+		case ERedMaterialParameterAuditFormat::Json:
+			Lines[Index] = (FirstRowIndex + Index > 0 ? TEXT(",\n") : TEXT("\n"))
+				+ RedMaterialParameterAudit::FormatJsonRow(Rows[Index]);
+			break;
+		case ERedMaterialParameterAuditFormat::JsonLines:
+			Lines[Index] = RedMaterialParameterAudit::FormatJsonRow(Rows[Index]) + TEXT("\n");
+			break;
+		default:
+			Lines[Index] = RedMaterialParameterAudit::FormatCsvRow(Rows[Index]);
+			break;
+		}
+	});
+
+	for (const FString& Line : Lines)
+	{
+		WriteString(Line);
+	}
+	NumWrittenRows += Rows.Num();
+}
+
+void FRedMaterialParameterAuditWriter::Close()
+{
+	if (!Archive)
+	{
+		return;
+	}
+
+	if (Format == ERedMaterialParameterAuditFormat::Json)
+	{
+		WriteString(TEXT("\n]\n"));
+	}
+	Archive->Close();
+	Archive.Reset();
+}
+
+void FRedMaterialParameterAuditWriter::WriteString(const FString& String)
+{
+	const FTCHARToUTF8 Utf8(*String);
+	Archive->Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+}
+
+bool FRedMaterialParameterAuditReader::ReadFile(
+	const FString& Filename,
+	TFunctionRef<void(const FRedMaterialParameterAuditRow&, ERedMaterialParameterAuditColumns)> Visitor)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialParameterAuditReader::ReadFile);
+	using namespace RedMaterialParameterAudit;
+
+	const bool bCsv = FRedMaterialParameterAuditWriter::GetFormatFromFilename(Filename)
+		== ERedMaterialParameterAuditFormat::Csv;
+
+	int32 LineNumber = 0;
+	int32 RecordStartLine = 0;
+	FString PendingRecord;
+	TArray<FString> Fields;
+	TArray<int32> ColumnIndices;
+
+	auto VisitCsvRecord = [&](const FStringView Record)
+	{
+		if (!ParseCsvRecord(Record, Fields))
+		{
+			return false;
+		}
+
+		// The first record is the header, it maps each field to a column.
+		if (ColumnIndices.Num() == 0)
+		{
+			for (const FString& Field : Fields)
+			{
+				int32& ColumnIndex = ColumnIndices.Add_GetRef(INDEX_NONE);
+				for (int32 Index = 0; Index < Column_Num; ++Index)
+				{
+					if (Field.TrimStartAndEnd().Equals(ColumnNames[Index], ESearchCase::IgnoreCase))
+					{
+						ColumnIndex = Index;
+						break;
+					}
+				}
+			}
+			return true;
+		}
+
+		// Short rows are allowed, the missing trailing columns are left out of the row.
+		FRedMaterialParameterAuditRow Row;
+		ERedMaterialParameterAuditColumns Columns = ERedMaterialParameterAuditColumns::None;
+		for (int32 FieldIndex = 0; FieldIndex < Fields.Num() && FieldIndex < ColumnIndices.Num(); ++FieldIndex)
+		{
+			const int32 ColumnIndex = ColumnIndices[FieldIndex];
+			if (ColumnIndex == INDEX_NONE)
+			{
+				continue;
+			}
+			if (!SetRowField(Row, ColumnIndex, Fields[FieldIndex]))
+			{
+				return false;
+			}
+			Columns |= GetColumnFlag(ColumnIndex);
+		}
+		Visitor(Row, Columns);
+		return true;
+	};
+
+	const bool bRead = FFileHelper::LoadFileToStringWithLineVisitor(*Filename, [&](const FStringView Line)
+	{
+		++LineNumber;
+		if (bCsv)
+		{
+			// A quoted field can span several lines, keep collecting until the quotes are balanced.
+			if (PendingRecord.IsEmpty())
+			{
+				RecordStartLine = LineNumber;
+			}
+			else
+			{
+				PendingRecord.AppendChar(TEXT('\n'));
+			}
+			PendingRecord.Append(Line);
+
+			int32 NumQuotes = 0;
+			for (const TCHAR Char : PendingRecord)
+			{
+				NumQuotes += Char == TEXT('"') ? 1 : 0;
+			}
+			if (NumQuotes % 2 != 0)
+			{
+				return;
+			}
+
+			if (!PendingRecord.TrimStartAndEnd().IsEmpty() && !VisitCsvRecord(PendingRecord))
+			{
+				UE_LOG(LogRedMaterialParameterAudit, Warning, TEXT("%s(%d): Skipping malformed row."), *Filename,
+				       RecordStartLine);
+			}
+			PendingRecord.Reset();
+			return;
+		}
+
+		// JSON rows are one object per line, with or without the enclosing array and separating commas.
+		FStringView Trimmed = Line.TrimStartAndEnd();
+		Trimmed.RemovePrefix(Trimmed.StartsWith(TEXT(',')) ? 1 : 0);
+		Trimmed.RemoveSuffix(Trimmed.EndsWith(TEXT(',')) ? 1 : 0);
+		Trimmed = Trimmed.TrimStartAndEnd();
+		if (Trimmed.IsEmpty() || Trimmed == TEXTVIEW("[") || Trimmed == TEXTVIEW("]"))
+		{
+			return;
+		}
+
+		FRedMaterialParameterAuditRow Row;
+		ERedMaterialParameterAuditColumns Columns;
+		if (ParseJsonRow(Trimmed, Row, Columns))
+		{
+			Visitor(Row, Columns);
+		}
+		else
+		{
+			UE_LOG(LogRedMaterialParameterAudit, Warning, TEXT("%s(%d): Skipping malformed row."), *Filename,
+			       LineNumber);
+		}
+	});
+
+	if (!bRead)
+	{
+		UE_LOG(LogRedMaterialParameterAudit, Error, TEXT("Could not read '%s'."), *Filename);
+		return false;
+	}
+	if (!PendingRecord.IsEmpty())
+	{
+		UE_LOG(LogRedMaterialParameterAudit, Warning, TEXT("%s(%d): Unterminated quoted field."), *Filename,
+		       RecordStartLine);
+	}
+	return true;
+}
+
+TArray<FAssetData> FRedMaterialParameterAudit::FindAssets(const FRedMaterialParameterAuditOptions& Options)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialParameterAudit::FindAssets);
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UMaterial::StaticClass()->GetClassPathName());
+	Filter.ClassPaths.Add(UMaterialFunction::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	Filter.PackagePaths = Options.PackagePaths;
+	if (Filter.PackagePaths.Num() == 0)
+	{
+		Filter.PackagePaths.Add(FName("/Game"));
+	}
+	Filter.bRecursivePaths = true;
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.EnumerateAssets(Filter, [&Assets, &Options](const FAssetData& AssetData)
+	{
+		if (IsPackageInShard(AssetData.PackageName, Options.Shard, Options.NumShards))
+		{
+			Assets.Add(AssetData);
+		}
+		return true;
+	});
+
+	// Sorted so batches group neighbouring packages and the output order is the same from run to run.
+	Assets.Sort([](const FAssetData& A, const FAssetData& B)
+	{
+		return A.PackageName.LexicalLess(B.PackageName);
+	});
+	return Assets;
+}
+
+bool FRedMaterialParameterAudit::IsPackageInShard(const FName PackageName, const int32 Shard, const int32 NumShards)
+{
+	if (NumShards <= 1)
+	{
+		return true;
+	}
+
+	// FName hashes aren't stable between processes, the shards have to agree without talking to each other.
+	const FString PackageNameString = PackageName.ToString().ToLower();
+	return FCrc::StrCrc32(*PackageNameString) % static_cast<uint32>(NumShards) == static_cast<uint32>(Shard);
+}
+
+void FRedMaterialParameterAudit::GatherRows(TConstArrayView<UObject*> MaterialsOrFunctions,
+                                            TArray<FRedMaterialParameterAuditRow>& OutRows)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialParameterAudit::GatherRows);
+	check(IsInGameThread());
+
+	// Expressions are live UObjects, so their metadata is read here on the game thread into plain rows. Only the
+	// formatting in FRedMaterialParameterAuditWriter runs on worker threads.
+	for (UObject* MaterialOrFunction : MaterialsOrFunctions)
+	{
+		const FString AssetPath = MaterialOrFunction->GetPathName();
+		const FName AssetClass = MaterialOrFunction->GetClass()->GetFName();
+		URedMaterialParameterBlueprintLibrary::ForEachMaterialParameterExpression(
+			MaterialOrFunction, false, [&](UMaterialExpression* Expression)
+			{
+				const FRedMaterialParameterInfo Info(Expression);
+
+				FRedMaterialParameterAuditRow& Row = OutRows.AddDefaulted_GetRef();
+				Row.Asset = AssetPath;
+				Row.AssetClass = AssetClass;
+				Row.ParameterName = Info.ParameterName;
+				Row.TypeName = URedMaterialParameterBlueprintLibrary::GetParameterExpressionTypeName(Expression);
+				Row.Group = Info.ParameterInfo.Group;
+				Row.SortPriority = Info.ParameterInfo.SortPriority;
+				Row.Description = Info.ParameterInfo.Description;
+				Row.ScalarMin = Info.ParameterInfo.ScalarMin;
+				Row.ScalarMax = Info.ParameterInfo.ScalarMax;
+				Row.ExpressionGuid = Info.ParameterInfo.ExpressionGuid;
+			});
+	}
+}
+
+int32 FRedMaterialParameterAudit::Run(const FRedMaterialParameterAuditOptions& Options,
+                                      FRedMaterialParameterAuditWriter& Writer)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialParameterAudit::Run);
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	const TArray<FAssetData> Assets = FindAssets(Options);
+	UE_LOG(LogRedMaterialParameterAudit, Display, TEXT("Auditing %d materials and material functions (shard %d of %d)."),
+	       Assets.Num(), Options.Shard, Options.NumShards);
+
+	const int32 BatchSize = FMath::Max(Options.BatchSize, 1);
+	int32 NumFailed = 0;
+	int32 NumLoadedSinceGC = 0;
+	TArray<UObject*> BatchObjects;
+	TArray<FRedMaterialParameterAuditRow> BatchRows;
+	for (int32 BatchStart = 0; BatchStart < Assets.Num(); BatchStart += BatchSize)
+	{
+		const int32 BatchEnd = FMath::Min(BatchStart + BatchSize, Assets.Num());
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialParameterAudit::LoadBatch);
+			for (int32 Index = BatchStart; Index < BatchEnd; ++Index)
+			{
+				LoadPackageAsync(Assets[Index].PackageName.ToString());
+			}
+			FlushAsyncLoading();
+		}
+
+		BatchObjects.Reset();
+		for (int32 Index = BatchStart; Index < BatchEnd; ++Index)
+		{
+			if (UObject* Object = Assets[Index].FastGetAsset(false))
+			{
+				BatchObjects.Add(Object);
+			}
+			else
+			{
+				UE_LOG(LogRedMaterialParameterAudit, Warning, TEXT("Failed to load '%s'."),
+				       *Assets[Index].GetObjectPathString());
+				++NumFailed;
+			}
+		}
+
+		BatchRows.Reset();
+		GatherRows(BatchObjects, BatchRows);
+		Writer.Write(BatchRows);
+
+		UE_LOG(LogRedMaterialParameterAudit, Display, TEXT("Audited %d/%d assets, %d parameters."),
+		       BatchEnd, Assets.Num(), Writer.GetNumWrittenRows());
+
+		NumLoadedSinceGC += BatchEnd - BatchStart;
+		if (NumLoadedSinceGC >= Options.PackagesPerGarbageCollection)
+		{
+			BatchObjects.Reset();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			NumLoadedSinceGC = 0;
+		}
+	}
+	return NumFailed;
+}
@@ -22,23 +22,525 @@
 
 #include "RedMaterialParameterBlueprintLibrary.h"
 
+#include "RedJsonStructFile.h"
+#include "RedMaterialEditBatch.h"
+#include "RedMaterialInstanceHierarchy.h"
+#include "RedMaterialParameterAudit.h"
+#include "RedMaterialParameterPreview.h"
+#include "Curves/CurveLinearColorAtlas.h"
 #include "Materials/Material.h"
 #include "Materials/MaterialExpressionCurveAtlasRowParameter.h"
 #include "Materials/MaterialExpressionScalarParameter.h"
 #include "Materials/MaterialExpressionVectorParameter.h"
 #include "Materials/MaterialFunction.h"
+#include "Materials/MaterialInstanceConstant.h"
 #include "Editor.h"
+#include "Engine/Texture.h"
+#include "FileHelpers.h"
+#include "HAL/FileManager.h"
 #include "IContentBrowserSingleton.h"
 #include "IMaterialEditor.h"
+#include "JsonObjectConverter.h"
 #include "MaterialEditorUtilities.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/EngineVersion.h"
 #include "Materials/MaterialExpressionCollectionParameter.h"
+#include "Materials/MaterialExpressionMaterialAttributeLayers.h"
+#include "Materials/MaterialExpressionMaterialFunctionCall.h"
 #include "Materials/MaterialExpressionTextureSampleParameter.h"
 #include "Materials/MaterialParameterCollection.h"
 #include "Subsystems/AssetEditorSubsystem.h"
 #include "Toolkits/ToolkitManager.h"
+#include "UObject/StrongObjectPtr.h"
+
+#define LOCTEXT_NAMESPACE "RedMaterialParameterBlueprintLibrary"
+
+DEFINE_LOG_CATEGORY(LogRedTechArtToolsBlueprintEditorLib);
+
+namespace RedMaterialParameterTraversal
+{
+	FName GetTypeName(const EMaterialParameterType Type)
+	{
+		switch (Type)
+		{
+		case EMaterialParameterType::Scalar:
+			return FName("Scalar");
+		case EMaterialParameterType::Vector:
+			return FName("Vector");
+		case EMaterialParameterType::DoubleVector:
+			return FName("DoubleVector");
+		case EMaterialParameterType::Texture:
+			return FName("Texture");
+		case EMaterialParameterType::Font:
+			return FName("Font");
+		case EMaterialParameterType::RuntimeVirtualTexture:
+			return FName("RuntimeVirtualTexture");
+		case EMaterialParameterType::StaticSwitch:
+			return FName("StaticSwitch");
+		case EMaterialParameterType::StaticComponentMask:
+			return FName("StaticComponentMask");
+		default:
+			return FName("None");
+		}
+	}
+
+	bool IsParameterExpression(const UMaterialExpression* Expression)
+	{
+		return Expression->bIsParameterExpression || Expression->IsA<UMaterialExpressionCollectionParameter>();
+	}
+
+	TConstArrayView<TObjectPtr<UMaterialExpression>> GetExpressions(const UMaterial* Material)
+	{
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION > 0
+		return Material->GetExpressions();
+#else
+		return Material->Expressions;
+#endif
+	}
+
+	TConstArrayView<TObjectPtr<UMaterialExpression>> GetExpressions(const UMaterialFunction* Function)
+	{
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION > 0
+		return Function->GetExpressions();
+#else
+		return Function->FunctionExpressions;
+#endif
+	}
+
+	void VisitExpressions(TConstArrayView<TObjectPtr<UMaterialExpression>> Expressions, bool bIncludeFunctions,
+	                      TSet<const UMaterialFunctionInterface*>& VisitedFunctions,
+	                      TFunctionRef<void(UMaterialExpression*)> Visitor);
+
+	void VisitFunction(UMaterialFunctionInterface* Function, const bool bIncludeFunctions,
+	                   TSet<const UMaterialFunctionInterface*>& VisitedFunctions,
+	                   TFunctionRef<void(UMaterialExpression*)> Visitor)
+	{
+		bool bAlreadyVisited = false;
+		VisitedFunctions.Add(Function, &bAlreadyVisited);
+		if (bAlreadyVisited)
+		{
+			return;
+		}
+
+		// Function instances don't have expressions of their own, walk the function they are an instance of.
+		if (const UMaterialFunction* BaseFunction = Function->GetBaseFunction())
+		{
+			VisitExpressions(GetExpressions(BaseFunction), bIncludeFunctions, VisitedFunctions, Visitor);
+		}
+	}
+
+	void VisitExpressions(TConstArrayView<TObjectPtr<UMaterialExpression>> Expressions, const bool bIncludeFunctions,
+	                      TSet<const UMaterialFunctionInterface*>& VisitedFunctions,
+	                      TFunctionRef<void(UMaterialExpression*)> Visitor)
+	{
+		for (UMaterialExpression* Expression : Expressions)
+		{
+			if (Expression == nullptr)
+			{
+				continue;
+			}
+
+			if (IsParameterExpression(Expression))
+			{
+				Visitor(Expression);
+			}
+			else if (bIncludeFunctions)
+			{
+				if (const auto* FunctionCall = Cast<UMaterialExpressionMaterialFunctionCall>(Expression))
+				{
+					if (FunctionCall->MaterialFunction)
+					{
+						VisitFunction(FunctionCall->MaterialFunction, bIncludeFunctions, VisitedFunctions, Visitor);
+					}
+				}
+				else if (const auto* Layers = Cast<UMaterialExpressionMaterialAttributeLayers>(Expression))
+				{
+					for (UMaterialFunctionInterface* Layer : Layers->DefaultLayers.Layers)
+					{
+						if (Layer != nullptr)
+						{
+							VisitFunction(Layer, bIncludeFunctions, VisitedFunctions, Visitor);
+						}
+					}
+					for (UMaterialFunctionInterface* Blend : Layers->DefaultLayers.Blends)
+					{
+						if (Blend != nullptr)
+						{
+							VisitFunction(Blend, bIncludeFunctions, VisitedFunctions, Visitor);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	TArray<FRedMaterialParameterInfo> GatherInfos(UObject* MaterialOrFunction, const bool bIncludeFunctions,
+	                                              const TArray<FName>& TypeNames, const TArray<FName>& Groups)
+	{
+		TArray<FRedMaterialParameterInfo> OutInfos;
+		URedMaterialParameterBlueprintLibrary::ForEachMaterialParameterExpression(
+			MaterialOrFunction, bIncludeFunctions, [&](UMaterialExpression* Expression)
+			{
+				// The type is cheap to check, only build the full info for parameters that can pass both filters.
+				if (TypeNames.Num() > 0
+					&& !TypeNames.Contains(URedMaterialParameterBlueprintLibrary::GetParameterExpressionTypeName(Expression)))
+				{
+					return;
+				}
+
+				FRedMaterialParameterInfo Info(Expression);
+				if (Groups.Num() > 0 && !Groups.Contains(Info.ParameterInfo.Group))
+				{
+					return;
+				}
+				OutInfos.Add(MoveTemp(Info));
+			});
+		return OutInfos;
+	}
+}
+
+namespace RedMaterialParameterEdits
+{
+	/** Batches opened from Blueprint or Python with BeginMaterialEditBatch, innermost last. */
+	TArray<TUniquePtr<FRedMaterialEditBatch>> ScriptBatches;
+
+	bool ChannelNamesEqual(const FParameterChannelNames& A, const FParameterChannelNames& B)
+	{
+		return A.R.EqualTo(B.R) && A.G.EqualTo(B.G) && A.B.EqualTo(B.B) && A.A.EqualTo(B.A);
+	}
+
+	/*
+	 * Each Apply function writes one field to the parameter's expression and returns true if anything changed.
+	 * Nothing is modified when the expression already has the value, and Modify goes through FRedMaterialEditBatch
+	 * so the same code serves both the single setters and batched edits.
+	 */
+
+	bool ApplyName(FRedMaterialParameterInfo& Info, const FName Name)
+	{
+		Info.ParameterName = Name;
+		UMaterialExpression* Expression = Info.OwningMaterialExpression.Get();
+		if (Expression == nullptr || Expression->GetParameterName() == Name)
+		{
+			return false;
+		}
+
+		FRedMaterialEditBatch::ModifyExpression(Expression);
+		Expression->SetParameterName(Name);
+		return true;
+	}
+
+	bool ApplyChannelNames(FRedMaterialParameterInfo& Info, const FParameterChannelNames& ChannelNames)
+	{
+		Info.ParameterInfo.ChannelNames = ChannelNames;
+		if (auto* Expression = Cast<UMaterialExpressionVectorParameter>(Info.OwningMaterialExpression.Get()))
+		{
+			if (!ChannelNamesEqual(Expression->ChannelNames, ChannelNames))
+			{
+				FRedMaterialEditBatch::ModifyExpression(Expression);
+				Expression->ChannelNames = ChannelNames;
+				return true;
+			}
+		}
+		if (auto* Expression = Cast<UMaterialExpressionTextureSampleParameter>(Info.OwningMaterialExpression.Get()))
+		{
+			if (!ChannelNamesEqual(Expression->ChannelNames, ChannelNames))
+			{
+				FRedMaterialEditBatch::ModifyExpression(Expression);
+				Expression->ChannelNames = ChannelNames;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Group and sort priority are written through SetParameterValue, which handles every parameter type. */
+	bool ApplyGroupAndSortPriority(FRedMaterialParameterInfo& Info)
+	{
+		UMaterialExpression* Expression = Info.OwningMaterialExpression.Get();
+		if (Expression == nullptr)
+		{
+			return false;
+		}
+
+		FMaterialParameterMetadata Current;
+		if (Expression->GetParameterValue(Current) && Current.Group == Info.ParameterInfo.Group
+			&& Current.SortPriority == Info.ParameterInfo.SortPriority)
+		{
+			return false;
+		}
+
+		FRedMaterialEditBatch::ModifyExpression(Expression);
+		Expression->SetParameterValue(Info.ParameterName, Info.ParameterInfo,
+		                              EMaterialExpressionSetParameterValueFlags::NoUpdateExpressionGuid |
+		                              EMaterialExpressionSetParameterValueFlags::AssignGroupAndSortPriority);
+		return true;
+	}
+
+	bool ApplyGroup(FRedMaterialParameterInfo& Info, const FName Group)
+	{
+		Info.ParameterInfo.Group = Group;
+		return ApplyGroupAndSortPriority(Info);
+	}
+
+	bool ApplySortPriority(FRedMaterialParameterInfo& Info, const int32 SortPriority)
+	{
+		Info.ParameterInfo.SortPriority = SortPriority;
+		return ApplyGroupAndSortPriority(Info);
+	}
+
+	bool ApplyDescription(FRedMaterialParameterInfo& Info, const FString& Description)
+	{
+		Info.ParameterInfo.Description = Description;
+		UMaterialExpression* Expression = Info.OwningMaterialExpression.Get();
+		if (Expression == nullptr || Expression->Desc == Description)
+		{
+			return false;
+		}
+
+		FRedMaterialEditBatch::ModifyExpression(Expression);
+		Expression->Desc = Description;
+		return true;
+	}
+
+	bool ApplyScalarMinMax(FRedMaterialParameterInfo& Info, const float ScalarMin, const float ScalarMax)
+	{
+		Info.ParameterInfo.ScalarMin = ScalarMin;
+		Info.ParameterInfo.ScalarMax = ScalarMax;
+		auto* Expression = Cast<UMaterialExpressionScalarParameter>(Info.OwningMaterialExpression.Get());
+		if (Expression == nullptr || (Expression->SliderMin == ScalarMin && Expression->SliderMax == ScalarMax))
+		{
+			return false;
+		}
+
+		FRedMaterialEditBatch::ModifyExpression(Expression);
+		Expression->SliderMin = ScalarMin;
+		Expression->SliderMax = ScalarMax;
+		return true;
+	}
+
+	bool ApplyScalarCurveAndAtlas(FRedMaterialParameterInfo& Info, UCurveLinearColor* ScalarCurve,
+	                              UCurveLinearColorAtlas* ScalarAtlas)
+	{
+		Info.ParameterInfo.ScalarCurve = ScalarCurve;
+		Info.ParameterInfo.ScalarAtlas = ScalarAtlas;
+		auto* Expression = Cast<UMaterialExpressionCurveAtlasRowParameter>(Info.OwningMaterialExpression.Get());
+		if (Expression == nullptr || (Expression->Curve == ScalarCurve && Expression->Atlas == ScalarAtlas))
+		{
+			return false;
+		}
+
+		FRedMaterialEditBatch::ModifyExpression(Expression);
+		Expression->Curve = ScalarCurve;
+		Expression->Atlas = ScalarAtlas;
+		return true;
+	}
+
+	/** Sets a parameter's default value if it has the given type and the value is different. */
+	bool ApplyDefaultValue(FRedMaterialParameterInfo& Info, const EMaterialParameterType Type,
+	                       const FMaterialParameterValue& Value)
+	{
+		UMaterialExpression* Expression = Info.OwningMaterialExpression.Get();
+		FMaterialParameterMetadata Current;
+		if (Expression == nullptr || Expression->GetParameterType() != Type || !Expression->GetParameterValue(Current))
+		{
+			return false;
+		}
+
+		Info.ParameterInfo.Value = Value;
+		if (Current.Value == Value)
+		{
+			return false;
+		}
+
+		FRedMaterialEditBatch::ModifyExpression(Expression);
+		Current.Value = Value;
+		Expression->SetParameterValue(Info.ParameterName, Current,
+		                              EMaterialExpressionSetParameterValueFlags::NoUpdateExpressionGuid);
+		return true;
+	}
+
+	/**
+	 * Loads an asset a preset entry refers to. Returns false if the reference is set but doesn't load, the value is
+	 * then skipped rather than cleared.
+	 */
+	template <typename TObject>
+	bool LoadPresetReference(const TSoftObjectPtr<TObject>& Reference, const FName ParameterName, TObject*& OutObject)
+	{
+		OutObject = Reference.LoadSynchronous();
+		if (OutObject == nullptr && !Reference.IsNull())
+		{
+			UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning,
+			       TEXT("Skipping the preset value of '%s', '%s' could not be loaded."), *ParameterName.ToString(),
+			       *Reference.ToString());
+			return false;
+		}
+		return true;
+	}
+
+	template <typename TValue>
+	int32 SetDefaultValues(TArray<FRedMaterialParameterInfo>& Infos, const TArray<TValue>& Values,
+	                       const EMaterialParameterType Type)
+	{
+		if (Infos.Num() != Values.Num())
+		{
+			UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning,
+			       TEXT("Got %d parameters but %d default values, nothing was set."), Infos.Num(), Values.Num());
+			return 0;
+		}
+
+		FRedMaterialEditBatch Batch(LOCTEXT("SetMaterialParameterDefaults", "Set Material Parameter Defaults"));
+		for (int32 Index = 0; Index < Infos.Num(); ++Index)
+		{
+			ApplyDefaultValue(Infos[Index], Type, FMaterialParameterValue(Values[Index]));
+		}
+		return Batch.GetNumModifiedExpressions();
+	}
+
+	/** Reads the current default of each parameter from its expression, Fallback for parameters of another type. */
+	template <typename TValue>
+	TArray<TValue> GetDefaultValues(const TArray<FRedMaterialParameterInfo>& Infos, const EMaterialParameterType Type,
+	                                TFunctionRef<TValue(const FMaterialParameterValue&)> Getter, const TValue& Fallback)
+	{
+		TArray<TValue> Values;
+		Values.Reserve(Infos.Num());
+		for (const FRedMaterialParameterInfo& Info : Infos)
+		{
+			UMaterialExpression* Expression = Info.OwningMaterialExpression.Get();
+			FMaterialParameterMetadata Current;
+			if (Expression != nullptr && Expression->GetParameterType() == Type && Expression->GetParameterValue(Current))
+			{
+				Values.Add(Getter(Current.Value));
+			}
+			else
+			{
+				Values.Add(Fallback);
+			}
+		}
+		return Values;
+	}
+
+	using FImportedRow = TPair<FRedMaterialParameterAuditRow, ERedMaterialParameterAuditColumns>;
+
+	/**
+	 * Diffs imported rows against the current metadata of one asset's parameters, and applies only the fields that
+	 * differ. Rows are matched by expression guid first, so renames come through, and by parameter name otherwise.
+	 */
+	void ApplyImportedRows(const FString& AssetPath, TConstArrayView<FImportedRow> Rows)
+	{
+		if (AssetPath.IsEmpty() || Rows.Num() == 0)
+		{
+			return;
+		}
+
+		UObject* Asset = LoadObject<UObject>(nullptr, *AssetPath);
+		if (!IsValid(Asset) || !(Asset->IsA<UMaterial>() || Asset->IsA<UMaterialFunction>()))
+		{
+			UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning,
+			       TEXT("Skipping %d imported parameters, '%s' is not a material or material function."), Rows.Num(),
+			       *AssetPath);
+			return;
+		}
+
+		TArray<FRedMaterialParameterInfo> Infos;
+		URedMaterialParameterBlueprintLibrary::ForEachMaterialParameterExpression(
+			Asset, false, [&Infos](UMaterialExpression* Expression)
+			{
+				Infos.Emplace(Expression);
+			});
+
+		TMap<FGuid, int32> InfosByGuid;
+		TMap<FName, int32> InfosByName;
+		for (int32 Index = 0; Index < Infos.Num(); ++Index)
+		{
+			InfosByGuid.Add(Infos[Index].ParameterInfo.ExpressionGuid, Index);
+			InfosByName.Add(Infos[Index].ParameterName, Index);
+		}
+
+		TArray<FRedMaterialParameterEdit> Edits;
+		for (const FImportedRow& ImportedRow : Rows)
+		{
+			const FRedMaterialParameterAuditRow& Row = ImportedRow.Key;
+			const ERedMaterialParameterAuditColumns Columns = ImportedRow.Value;
+
+			const int32* InfoIndex = nullptr;
+			if (EnumHasAnyFlags(Columns, ERedMaterialParameterAuditColumns::ExpressionGuid) && Row.ExpressionGuid.IsValid())
+			{
+				InfoIndex = InfosByGuid.Find(Row.ExpressionGuid);
+			}
+			const bool bMatchedByGuid = InfoIndex != nullptr;
+			if (!bMatchedByGuid && EnumHasAnyFlags(Columns, ERedMaterialParameterAuditColumns::ParameterName))
+			{
+				InfoIndex = InfosByName.Find(Row.ParameterName);
+			}
+			if (InfoIndex == nullptr)
+			{
+				UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning, TEXT("No parameter '%s' (%s) in '%s'."),
+				       *Row.ParameterName.ToString(), *Row.ExpressionGuid.ToString(), *AssetPath);
+				continue;
+			}
+
+			const FRedMaterialParameterInfo& Info = Infos[*InfoIndex];
+			const FMaterialParameterMetadata& Current = Info.ParameterInfo;
+			FRedMaterialParameterEdit Edit(Info);
+			if (bMatchedByGuid && EnumHasAnyFlags(Columns, ERedMaterialParameterAuditColumns::ParameterName)
+				&& Row.ParameterName != Info.ParameterName)
+			{
+				Edit.bSetName = true;
+				Edit.Name = Row.ParameterName;
+			}
+			if (EnumHasAnyFlags(Columns, ERedMaterialParameterAuditColumns::Group) && Row.Group != Current.Group)
+			{
+				Edit.bSetGroup = true;
+				Edit.Group = Row.Group;
+			}
+			if (EnumHasAnyFlags(Columns, ERedMaterialParameterAuditColumns::SortPriority)
+				&& Row.SortPriority != Current.SortPriority)
+			{
+				Edit.bSetSortPriority = true;
+				Edit.SortPriority = Row.SortPriority;
+			}
+			if (EnumHasAnyFlags(Columns, ERedMaterialParameterAuditColumns::Description)
+				&& !Row.Description.Equals(Current.Description, ESearchCase::CaseSensitive))
+			{
+				Edit.bSetDescription = true;
+				Edit.Description = Row.Description;
+			}
+			if (Info.ParameterType == EMaterialParameterType::Scalar)
+			{
+				const float ScalarMin = EnumHasAnyFlags(Columns, ERedMaterialParameterAuditColumns::ScalarMin)
+					                        ? Row.ScalarMin
+					                        : Current.ScalarMin;
+				const float ScalarMax = EnumHasAnyFlags(Columns, ERedMaterialParameterAuditColumns::ScalarMax)
+					                        ? Row.ScalarMax
+					                        : Current.ScalarMax;
+				if (ScalarMin != Current.ScalarMin || ScalarMax != Current.ScalarMax)
+				{
+					Edit.bSetScalarMinMax = true;
+					Edit.ScalarMin = ScalarMin;
+					Edit.ScalarMax = ScalarMax;
+				}
+			}
+
+			if (Edit.bSetName || Edit.bSetGroup || Edit.bSetSortPriority || Edit.bSetDescription || Edit.bSetScalarMinMax)
+			{
+				Edits.Add(MoveTemp(Edit));
+			}
+		}
+
+		if (Edits.Num() > 0)
+		{
+			URedMaterialParameterBlueprintLibrary::ApplyMaterialParameterEdits(Edits);
+		}
+	}
+}
 
 bool URedMaterialParameterBlueprintLibrary::OpenAndFocusMaterialExpression(UMaterialExpression* MaterialExpression)
 {
+	// There is no editor UI to open in commandlets and unattended runs.
+	if(GEditor == nullptr || IsRunningCommandlet() || FApp::IsUnattended())
+		return false;
+
 	UAssetEditorSubsystem* AssetEditorSubsystem = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>();
 	if(!IsValid(AssetEditorSubsystem))
 		return false;
@@ -86,65 +588,81 @@ UObject* URedMaterialParameterBlueprintLibrary::GetMaterialExpression_OwningObje
 TArray<UMaterialExpression*> URedMaterialParameterBlueprintLibrary::GetAllMaterialParameterExpressions(
 	UMaterialInterface* MaterialInterface, bool bExcludeFunctions /*=false*/)
 {
-	TArray<const UMaterialExpression*> ConstAllExpressions;
-	TArray<UMaterialExpression*> AllExpressions;
 	TArray<UMaterialExpression*> OutExpressions;
-
-	if (bExcludeFunctions)
+	if (IsValid(MaterialInterface))
 	{
-		MaterialInterface->GetBaseMaterial()->GetAllExpressionsOfType<UMaterialExpression>(
-			ConstAllExpressions);
+		ForEachMaterialParameterExpression(MaterialInterface->GetBaseMaterial(), !bExcludeFunctions,
+		                                   [&OutExpressions](UMaterialExpression* Expression)
+		                                   {
+			                                   OutExpressions.Add(Expression);
+		                                   });
 	}
-	else
+	return OutExpressions;
+}
+
+TArray<UMaterialExpression*> URedMaterialParameterBlueprintLibrary::GetAllMaterialParameterExpressionsInFunction(
+	UMaterialFunction* MaterialFunction, bool bExcludeContainedFunctions)
+{
+	TArray<UMaterialExpression*> OutExpressions;
+	ForEachMaterialParameterExpression(MaterialFunction, !bExcludeContainedFunctions,
+	                                   [&OutExpressions](UMaterialExpression* Expression)
+	                                   {
+		                                   OutExpressions.Add(Expression);
+	                                   });
+	return OutExpressions;
+}
+
+TArray<FRedMaterialParameterInfo> URedMaterialParameterBlueprintLibrary::GetAllMaterialParameterInfos(
+	UMaterialInterface* MaterialInterface, bool bExcludeFunctions, const TArray<FName>& TypeNames,
+	const TArray<FName>& Groups)
+{
+	if (!IsValid(MaterialInterface))
 	{
-		MaterialInterface->GetBaseMaterial()->GetAllExpressionsInMaterialAndFunctionsOfType<UMaterialExpression>(
-			AllExpressions);
+		return {};
 	}
+	return RedMaterialParameterTraversal::GatherInfos(MaterialInterface->GetBaseMaterial(), !bExcludeFunctions,
+	                                                  TypeNames, Groups);
+}
+
+TArray<FRedMaterialParameterInfo> URedMaterialParameterBlueprintLibrary::GetAllMaterialParameterInfosInFunction(
+	UMaterialFunction* MaterialFunction, bool bExcludeContainedFunctions, const TArray<FName>& TypeNames,
+	const TArray<FName>& Groups)
+{
+	return RedMaterialParameterTraversal::GatherInfos(MaterialFunction, !bExcludeContainedFunctions, TypeNames, Groups);
+}
 
-	for (auto* Expression : AllExpressions)
+void URedMaterialParameterBlueprintLibrary::ForEachMaterialParameterExpression(
+	UObject* MaterialOrFunction, const bool bIncludeFunctions, TFunctionRef<void(UMaterialExpression*)> Visitor)
+{
+	TSet<const UMaterialFunctionInterface*> VisitedFunctions;
+	if (const UMaterial* Material = Cast<UMaterial>(MaterialOrFunction))
 	{
-		if (Expression->bIsParameterExpression)
-		{
-			OutExpressions.Add(Expression);
-		}
-		else if(Expression->IsA(UMaterialExpressionCollectionParameter::StaticClass()))
-		{
-			OutExpressions.Add(Expression);
-		}
+		RedMaterialParameterTraversal::VisitExpressions(RedMaterialParameterTraversal::GetExpressions(Material),
+		                                                bIncludeFunctions, VisitedFunctions, Visitor);
 	}
-	for (auto* Expression : ConstAllExpressions)
+	else if (UMaterialFunctionInterface* Function = Cast<UMaterialFunctionInterface>(MaterialOrFunction))
 	{
-		if (Expression->bIsParameterExpression)
-		{
-			OutExpressions.Add(const_cast<UMaterialExpression*>(Expression));
-		}
-		else if(Expression->IsA(UMaterialExpressionCollectionParameter::StaticClass()))
+		// Walk the function itself even if bIncludeFunctions is off, only the functions it calls are skipped.
+		VisitedFunctions.Add(Function);
+		if (const UMaterialFunction* BaseFunction = Function->GetBaseFunction())
 		{
-			OutExpressions.Add(const_cast<UMaterialExpression*>(Expression));
+			RedMaterialParameterTraversal::VisitExpressions(RedMaterialParameterTraversal::GetExpressions(BaseFunction),
+			                                                bIncludeFunctions, VisitedFunctions, Visitor);
 		}
 	}
-	return OutExpressions;
 }
 
-TArray<UMaterialExpression*> URedMaterialParameterBlueprintLibrary::GetAllMaterialParameterExpressionsInFunction(
-	UMaterialFunction* MaterialFunction, bool bExcludeContainedFunctions)
+FName URedMaterialParameterBlueprintLibrary::GetParameterExpressionTypeName(const UMaterialExpression* Expression)
 {
-	TArray<UMaterialExpression*> AllExpressions;
-	TArray<UMaterialExpression*> OutExpressions;
-	MaterialFunction->GetAllExpressionsOfType<UMaterialExpression>(
-		AllExpressions, !bExcludeContainedFunctions);
-	for (auto* Expression : AllExpressions)
+	if (!IsValid(Expression))
 	{
-		if (Expression->bIsParameterExpression)
-		{
-			OutExpressions.Add(Expression);
-		}
-		else if(Expression->IsA(UMaterialExpressionCollectionParameter::StaticClass()))
-		{
-			OutExpressions.Add(Expression);
-		}
+		return FName("None");
 	}
-	return OutExpressions;
+	if (Expression->IsA<UMaterialExpressionCollectionParameter>())
+	{
+		return FName("CollectionParameter");
+	}
+	return RedMaterialParameterTraversal::GetTypeName(Expression->GetParameterType());
 }
 
 FRedMaterialParameterInfo URedMaterialParameterBlueprintLibrary::GetMaterialParameterInfo(
@@ -177,27 +695,7 @@ FName URedMaterialParameterBlueprintLibrary::GetMaterialParameter_Name(const FRe
 
 FName URedMaterialParameterBlueprintLibrary::GetMaterialParameter_TypeName(const FRedMaterialParameterInfo& Info)
 {
-	switch (Info.ParameterType)
-	{
-	case EMaterialParameterType::Scalar:
-		return FName("Scalar");
-	case EMaterialParameterType::Vector:
-		return FName("Vector");
-	case EMaterialParameterType::DoubleVector:
-		return FName("DoubleVector");
-	case EMaterialParameterType::Texture:
-		return FName("Texture");
-	case EMaterialParameterType::Font:
-		return FName("Font");
-	case EMaterialParameterType::RuntimeVirtualTexture:
-		return FName("RuntimeVirtualTexture");
-	case EMaterialParameterType::StaticSwitch:
-		return FName("StaticSwitch");
-	case EMaterialParameterType::StaticComponentMask:
-		return FName("StaticComponentMask");
-	default:
-		return FName("None");
-	}
+	return RedMaterialParameterTraversal::GetTypeName(Info.ParameterType);
 }
 
 FRedParameterChannelNamesWrapper URedMaterialParameterBlueprintLibrary::GetMaterialParameter_ChannelNames(
@@ -264,86 +762,45 @@ TSoftObjectPtr<UCurveLinearColorAtlas> URedMaterialParameterBlueprintLibrary::Ge
 
 void URedMaterialParameterBlueprintLibrary::SetMaterialParameter_Name(FRedMaterialParameterInfo& Info, FName Name)
 {
-	Info.ParameterName = Name;
-	if (auto* Expression = Info.OwningMaterialExpression.Get())
-	{
-		Expression->Modify();
-		Expression->SetParameterName(Name);
-	}
+	RedMaterialParameterEdits::ApplyName(Info, Name);
 }
 
 void URedMaterialParameterBlueprintLibrary::SetMaterialParameter_ChannelNames(FRedMaterialParameterInfo& Info,
                                                                               FRedParameterChannelNamesWrapper
                                                                               ChannelNamesWrapper)
 {
-	Info.ParameterInfo.ChannelNames = ChannelNamesWrapper.ToParameterChannelNames();
-	if (auto* Expression = Cast<UMaterialExpressionVectorParameter>(Info.OwningMaterialExpression.Get()))
-	{
-		Expression->Modify();
-		Expression->ChannelNames = Info.ParameterInfo.ChannelNames;
-	}
-	if (auto* Expression = Cast<UMaterialExpressionTextureSampleParameter>(Info.OwningMaterialExpression.Get()))
-	{
-		Expression->Modify();
-		Expression->ChannelNames = Info.ParameterInfo.ChannelNames;
-	}
+	RedMaterialParameterEdits::ApplyChannelNames(Info, ChannelNamesWrapper.ToParameterChannelNames());
 }
 
 void URedMaterialParameterBlueprintLibrary::SetMaterialParameter_Group(FRedMaterialParameterInfo& Info,
                                                                        FName Group)
 {
-	Info.ParameterInfo.Group = Group;
-	if (auto* Expression = Info.OwningMaterialExpression.Get())
-	{
-		Expression->Modify();
-		Expression->SetParameterValue(Info.ParameterName, Info.ParameterInfo,
-		                              EMaterialExpressionSetParameterValueFlags::NoUpdateExpressionGuid |
-		                              EMaterialExpressionSetParameterValueFlags::AssignGroupAndSortPriority);
-	}
+	RedMaterialParameterEdits::ApplyGroup(Info, Group);
 }
 
 void URedMaterialParameterBlueprintLibrary::SetMaterialParameter_Description(FRedMaterialParameterInfo& Info,
                                                                              FString Description)
 {
-	Info.ParameterInfo.Description = Description;
-	if (auto* Expression = Info.OwningMaterialExpression.Get())
-	{
-		Expression->Modify();
-		Expression->Desc = Description;
-	}
+	RedMaterialParameterEdits::ApplyDescription(Info, Description);
 }
 
 void URedMaterialParameterBlueprintLibrary::SetMaterialParameter_SortPriority(FRedMaterialParameterInfo& Info,
                                                                               int32 SortPriority)
 {
-	Info.ParameterInfo.SortPriority = SortPriority;
-	if (auto* Expression = Info.OwningMaterialExpression.Get())
-	{
-		Expression->Modify();
-		Expression->SetParameterValue(Info.ParameterName, Info.ParameterInfo,
-		                              EMaterialExpressionSetParameterValueFlags::NoUpdateExpressionGuid |
-		                              EMaterialExpressionSetParameterValueFlags::AssignGroupAndSortPriority);
-	}
+	RedMaterialParameterEdits::ApplySortPriority(Info, SortPriority);
 }
 
 void URedMaterialParameterBlueprintLibrary::SetMaterialParameter_ScalarMinMax(FRedMaterialParameterInfo& Info,
                                                                               float ScalarMin, float ScalarMax)
 {
-	Info.ParameterInfo.ScalarMin = ScalarMin;
-	Info.ParameterInfo.ScalarMin = ScalarMax;
-	if (auto* Expression = Cast<UMaterialExpressionScalarParameter>(Info.OwningMaterialExpression.Get()))
-	{
-		Expression->Modify();
-		Expression->SliderMin = ScalarMin;
-		Expression->SliderMax = ScalarMax;
-	}
+	RedMaterialParameterEdits::ApplyScalarMinMax(Info, ScalarMin, ScalarMax);
 }
 
 void URedMaterialParameterBlueprintLibrary::UpdateMaterialParameter_ExpressionGUID(FRedMaterialParameterInfo& Info)
 {
 	if (auto* Expression = Info.OwningMaterialExpression.Get())
 	{
-		Expression->Modify();
+		FRedMaterialEditBatch::ModifyExpression(Expression);
 		Expression->UpdateParameterGuid(true, true);
 		Info.ParameterInfo.ExpressionGuid = Expression->GetParameterExpressionId();
 	}
@@ -354,7 +811,7 @@ void URedMaterialParameterBlueprintLibrary::SetMaterialParameter_ScalarCurve(FRe
 {
 	if (auto* Expression = Cast<UMaterialExpressionCurveAtlasRowParameter>(Info.OwningMaterialExpression.Get()))
 	{
-		Expression->Modify();
+		FRedMaterialEditBatch::ModifyExpression(Expression);
 		Expression->Curve = ScalarCurve;
 	}
 }
@@ -364,7 +821,754 @@ void URedMaterialParameterBlueprintLibrary::SetMaterialParameter_ScalarAtlas(FRe
 {
 	if (auto* Expression = Cast<UMaterialExpressionCurveAtlasRowParameter>(Info.OwningMaterialExpression.Get()))
 	{
-		Expression->Modify();
+		FRedMaterialEditBatch::ModifyExpression(Expression);
 		Expression->Atlas = ScalarAtlas;
 	}
 }
+
+int32 URedMaterialParameterBlueprintLibrary::ApplyMaterialParameterEdits(const TArray<FRedMaterialParameterEdit>& Edits)
+{
+	using namespace RedMaterialParameterEdits;
+
+	FRedMaterialEditBatch Batch(LOCTEXT("ApplyMaterialParameterEdits", "Apply Material Parameter Edits"));
+	for (const FRedMaterialParameterEdit& Edit : Edits)
+	{
+		FRedMaterialParameterInfo Info = Edit.Info;
+		if (Edit.bSetName)
+		{
+			ApplyName(Info, Edit.Name);
+		}
+		if (Edit.bSetChannelNames)
+		{
+			ApplyChannelNames(Info, Edit.ChannelNames.ToParameterChannelNames());
+		}
+		if (Edit.bSetGroup || Edit.bSetSortPriority)
+		{
+			if (Edit.bSetGroup)
+			{
+				Info.ParameterInfo.Group = Edit.Group;
+			}
+			if (Edit.bSetSortPriority)
+			{
+				Info.ParameterInfo.SortPriority = Edit.SortPriority;
+			}
+			ApplyGroupAndSortPriority(Info);
+		}
+		if (Edit.bSetDescription)
+		{
+			ApplyDescription(Info, Edit.Description);
+		}
+		if (Edit.bSetScalarMinMax)
+		{
+			ApplyScalarMinMax(Info, Edit.ScalarMin, Edit.ScalarMax);
+		}
+	}
+	return Batch.GetNumModifiedExpressions();
+}
+
+void URedMaterialParameterBlueprintLibrary::BeginMaterialEditBatch(const FText& Description)
+{
+	RedMaterialParameterEdits::ScriptBatches.Add(MakeUnique<FRedMaterialEditBatch>(
+		Description.IsEmpty() ? LOCTEXT("MaterialEditBatch", "Edit Material Parameters") : Description));
+}
+
+int32 URedMaterialParameterBlueprintLibrary::EndMaterialEditBatch(const bool bWaitForCompilation)
+{
+	TArray<TUniquePtr<FRedMaterialEditBatch>>& ScriptBatches = RedMaterialParameterEdits::ScriptBatches;
+	if (ScriptBatches.Num() == 0)
+	{
+		UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning,
+		       TEXT("EndMaterialEditBatch called without a matching BeginMaterialEditBatch."));
+		return 0;
+	}
+
+	if (FRedMaterialEditBatch::GetActive() != ScriptBatches.Last().Get())
+	{
+		UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning,
+		       TEXT("EndMaterialEditBatch called while a native material edit batch is still open."));
+		return 0;
+	}
+
+	TUniquePtr<FRedMaterialEditBatch> Batch = ScriptBatches.Pop();
+	return Batch->Finish(bWaitForCompilation);
+}
+
+bool URedMaterialParameterBlueprintLibrary::IsMaterialEditBatchActive()
+{
+	return RedMaterialParameterEdits::ScriptBatches.Num() > 0;
+}
+
+void URedMaterialParameterBlueprintLibrary::EndAllMaterialEditBatches()
+{
+	TArray<TUniquePtr<FRedMaterialEditBatch>>& ScriptBatches = RedMaterialParameterEdits::ScriptBatches;
+	while (ScriptBatches.Num() > 0 && FRedMaterialEditBatch::GetActive() == ScriptBatches.Last().Get())
+	{
+		ScriptBatches.Pop()->Finish();
+	}
+
+	// A native batch is still open above them, so they can't be finished in order. They are leaked rather than
+	// asserting when the array is destroyed.
+	if (ScriptBatches.Num() > 0)
+	{
+		UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning,
+		       TEXT("%d material edit batches could not be ended because a native batch is still open."),
+		       ScriptBatches.Num());
+		for (TUniquePtr<FRedMaterialEditBatch>& Batch : ScriptBatches)
+		{
+			Batch.Release();
+		}
+		ScriptBatches.Empty();
+	}
+}
+
+void URedMaterialParameterBlueprintLibrary::BeginMaterialParameterPreview(const FText& Description)
+{
+	FRedMaterialParameterPreview::Begin(
+		Description.IsEmpty() ? LOCTEXT("MaterialParameterPreview", "Edit Material Parameters") : Description);
+}
+
+int32 URedMaterialParameterBlueprintLibrary::EndMaterialParameterPreview(const bool bCommit)
+{
+	return FRedMaterialParameterPreview::End(bCommit);
+}
+
+bool URedMaterialParameterBlueprintLibrary::IsMaterialParameterPreviewActive()
+{
+	return FRedMaterialParameterPreview::GetActive() != nullptr;
+}
+
+TArray<FRedIndexedMaterialParameter> URedMaterialParameterBlueprintLibrary::FindIndexedMaterialParametersByName(
+	const FName ParameterName)
+{
+	return FRedMaterialParameterIndex::Get().FindByName(ParameterName);
+}
+
+TArray<FRedIndexedMaterialParameter> URedMaterialParameterBlueprintLibrary::FindIndexedMaterialParametersByGroup(
+	const FName Group)
+{
+	return FRedMaterialParameterIndex::Get().FindByGroup(Group);
+}
+
+TArray<FRedIndexedMaterialParameter> URedMaterialParameterBlueprintLibrary::GetIndexedMaterialParameters(
+	const FSoftObjectPath& Asset)
+{
+	return FRedMaterialParameterIndex::Get().GetParameters(Asset);
+}
+
+TArray<FSoftObjectPath> URedMaterialParameterBlueprintLibrary::GetUnindexedMaterialAssets()
+{
+	return FRedMaterialParameterIndex::Get().GetUnindexedAssets();
+}
+
+FRedMaterialParameterConsistencyReport URedMaterialParameterBlueprintLibrary::CheckMaterialParameterConsistency(
+	const TArray<FName>& PackagePaths, const bool bLoadUntaggedAssets)
+{
+	return FRedMaterialParameterConsistency::Check(PackagePaths, bLoadUntaggedAssets);
+}
+
+bool URedMaterialParameterBlueprintLibrary::ExportMaterialParameterConsistencyReport(
+	const FRedMaterialParameterConsistencyReport& Report, const FString& Filename)
+{
+	return FRedMaterialParameterConsistency::ExportReport(Report, Filename);
+}
+
+TArray<FRedIndexedMaterialExpression> URedMaterialParameterBlueprintLibrary::FindMaterialExpressions(
+	const FString& Query)
+{
+	return FRedMaterialExpressionIndex::Get().Find(Query);
+}
+
+UMaterialExpression* URedMaterialParameterBlueprintLibrary::ResolveIndexedMaterialExpression(
+	const FRedIndexedMaterialExpression& Expression)
+{
+	return FRedMaterialExpressionIndex::ResolveExpression(Expression);
+}
+
+FRedCollectionUsageReport URedMaterialParameterBlueprintLibrary::AnalyzeMaterialParameterCollectionUsage(
+	UMaterialParameterCollection* Collection, const bool bLoadUnindexedAssets)
+{
+	return FRedMaterialParameterCollectionUsage::Analyze(Collection, bLoadUnindexedAssets);
+}
+
+FRedCollectionUsageReport URedMaterialParameterBlueprintLibrary::PruneUnusedMaterialParameterCollectionParameters(
+	UMaterialParameterCollection* Collection, const bool bDryRun, const bool bSavePackage,
+	const bool bIgnoreOtherReferencers)
+{
+	const FRedCollectionUsageReport Report = FRedMaterialParameterCollectionUsage::Analyze(Collection, true);
+	UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Display,
+	       TEXT("'%s' has %d of %d parameters unused, its uniform buffer would shrink from %d to %d bytes."),
+	       *Report.Collection.ToString(), Report.UnusedParameters.Num(), Report.Parameters.Num(),
+	       Report.UniformBufferBytes, Report.PrunedUniformBufferBytes);
+	if (bDryRun || Report.UnusedParameters.Num() == 0)
+	{
+		return Report;
+	}
+
+	const int32 NumRemoved = FRedMaterialParameterCollectionUsage::PruneUnusedParameters(Collection, Report,
+	                                                                                     bIgnoreOtherReferencers);
+	if (NumRemoved > 0 && bSavePackage)
+	{
+		FRedMaterialInstanceHierarchy::SavePackages({Collection->GetPackage()});
+	}
+	return Report;
+}
+
+bool URedMaterialParameterBlueprintLibrary::OpenIndexedMaterialExpression(
+	const FRedIndexedMaterialExpression& Expression)
+{
+	UMaterialExpression* MaterialExpression = FRedMaterialExpressionIndex::ResolveExpression(Expression);
+	return IsValid(MaterialExpression) && OpenAndFocusMaterialExpression(MaterialExpression);
+}
+
+bool URedMaterialParameterBlueprintLibrary::ExportMaterialParameters(const TArray<UObject*>& MaterialsOrFunctions,
+                                                                    const FString& Filename, int32& OutNumParameters)
+{
+	OutNumParameters = 0;
+	const TUniquePtr<FRedMaterialParameterAuditWriter> Writer = FRedMaterialParameterAuditWriter::Create(
+		Filename, FRedMaterialParameterAuditWriter::GetFormatFromFilename(Filename));
+	if (!Writer)
+	{
+		return false;
+	}
+
+	TArray<UObject*> Assets;
+	for (UObject* Object : MaterialsOrFunctions)
+	{
+		if (IsValid(Object) && (Object->IsA<UMaterial>() || Object->IsA<UMaterialFunction>()))
+		{
+			Assets.Add(Object);
+		}
+		else if (IsValid(Object))
+		{
+			UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning,
+			       TEXT("Not exporting '%s', only materials and material functions have parameters to export."),
+			       *Object->GetPathName());
+		}
+	}
+
+	// Written a few assets at a time, so only a small part of the document is ever in memory.
+	constexpr int32 AssetsPerWrite = 32;
+	TArray<FRedMaterialParameterAuditRow> Rows;
+	for (int32 Start = 0; Start < Assets.Num(); Start += AssetsPerWrite)
+	{
+		Rows.Reset();
+		FRedMaterialParameterAudit::GatherRows(
+			MakeArrayView(Assets).Slice(Start, FMath::Min(AssetsPerWrite, Assets.Num() - Start)), Rows);
+		Writer->Write(Rows);
+	}
+	Writer->Close();
+
+	OutNumParameters = Writer->GetNumWrittenRows();
+	return true;
+}
+
+bool URedMaterialParameterBlueprintLibrary::ImportMaterialParameters(const FString& Filename,
+                                                                    int32& OutNumModifiedParameters)
+{
+	using namespace RedMaterialParameterEdits;
+
+	OutNumModifiedParameters = 0;
+	FRedMaterialEditBatch Batch(LOCTEXT("ImportMaterialParameters", "Import Material Parameters"));
+
+	// Rows are applied an asset at a time as they are read, exported files keep each asset's rows together.
+	FString CurrentAsset;
+	TArray<FImportedRow> AssetRows;
+	const bool bRead = FRedMaterialParameterAuditReader::ReadFile(
+		Filename, [&](const FRedMaterialParameterAuditRow& Row, const ERedMaterialParameterAuditColumns Columns)
+		{
+			if (!EnumHasAnyFlags(Columns, ERedMaterialParameterAuditColumns::Asset))
+			{
+				return;
+			}
+			if (Row.Asset != CurrentAsset)
+			{
+				ApplyImportedRows(CurrentAsset, AssetRows);
+				AssetRows.Reset();
+				CurrentAsset = Row.Asset;
+			}
+			AssetRows.Emplace(Row, Columns);
+		});
+	ApplyImportedRows(CurrentAsset, AssetRows);
+
+	OutNumModifiedParameters = Batch.GetNumModifiedExpressions();
+	return bRead;
+}
+
+FRedMaterialParameterPreset URedMaterialParameterBlueprintLibrary::CaptureMaterialParameterPreset(
+	UObject* MaterialOrFunction, const bool bIncludeFunctions)
+{
+	FRedMaterialParameterPreset Preset;
+	if (!IsValid(MaterialOrFunction))
+	{
+		return Preset;
+	}
+
+	Preset.Source = FSoftObjectPath(MaterialOrFunction);
+	ForEachMaterialParameterExpression(MaterialOrFunction, bIncludeFunctions, [&Preset](UMaterialExpression* Expression)
+	{
+		if (Expression->IsA<UMaterialExpressionCollectionParameter>())
+		{
+			return;
+		}
+
+		const FRedMaterialParameterInfo Info(Expression);
+		const FMaterialParameterMetadata& Metadata = Info.ParameterInfo;
+		FRedMaterialParameterPresetEntry& Entry = Preset.Parameters.AddDefaulted_GetRef();
+		Entry.ParameterName = Info.ParameterName;
+		Entry.ExpressionGuid = Metadata.ExpressionGuid;
+		Entry.TypeName = GetParameterExpressionTypeName(Expression);
+		Entry.Group = Metadata.Group;
+		Entry.SortPriority = Metadata.SortPriority;
+		Entry.Description = Metadata.Description;
+		Entry.ScalarMin = Metadata.ScalarMin;
+		Entry.ScalarMax = Metadata.ScalarMax;
+		Entry.ChannelNames = Metadata.ChannelNames;
+		Entry.ScalarCurve = Metadata.ScalarCurve;
+		Entry.ScalarAtlas = Metadata.ScalarAtlas;
+		switch (Info.ParameterType)
+		{
+		case EMaterialParameterType::Scalar:
+			Entry.ScalarValue = Metadata.Value.AsScalar();
+			break;
+		case EMaterialParameterType::Vector:
+			Entry.VectorValue = Metadata.Value.AsLinearColor();
+			break;
+		case EMaterialParameterType::DoubleVector:
+			Entry.DoubleVectorValue = Metadata.Value.AsVector4d();
+			break;
+		case EMaterialParameterType::Texture:
+			Entry.TextureValue = Metadata.Value.AsTextureObject();
+			break;
+		case EMaterialParameterType::StaticSwitch:
+			Entry.bStaticSwitchValue = Metadata.Value.AsStaticSwitch();
+			break;
+		case EMaterialParameterType::StaticComponentMask:
+			Entry.bStaticComponentMaskR = Metadata.Value.Bool[0];
+			Entry.bStaticComponentMaskG = Metadata.Value.Bool[1];
+			Entry.bStaticComponentMaskB = Metadata.Value.Bool[2];
+			Entry.bStaticComponentMaskA = Metadata.Value.Bool[3];
+			break;
+		default:
+			break;
+		}
+	});
+	return Preset;
+}
+
+int32 URedMaterialParameterBlueprintLibrary::ApplyMaterialParameterPreset(
+	UObject* MaterialOrFunction, const FRedMaterialParameterPreset& Preset, const bool bIncludeFunctions)
+{
+	using namespace RedMaterialParameterEdits;
+
+	if (!IsValid(MaterialOrFunction) || Preset.Parameters.Num() == 0)
+	{
+		return 0;
+	}
+
+	TArray<FRedMaterialParameterInfo> Infos = RedMaterialParameterTraversal::GatherInfos(
+		MaterialOrFunction, bIncludeFunctions, {}, {});
+	TMap<FGuid, int32> InfosByGuid;
+	TMap<FName, int32> InfosByName;
+	for (int32 Index = 0; Index < Infos.Num(); ++Index)
+	{
+		InfosByGuid.Add(Infos[Index].ParameterInfo.ExpressionGuid, Index);
+		InfosByName.Add(Infos[Index].ParameterName, Index);
+	}
+
+	FRedMaterialEditBatch Batch(LOCTEXT("ApplyMaterialParameterPreset", "Apply Material Parameter Preset"));
+	for (const FRedMaterialParameterPresetEntry& Entry : Preset.Parameters)
+	{
+		const int32* InfoIndex = Entry.ExpressionGuid.IsValid() ? InfosByGuid.Find(Entry.ExpressionGuid) : nullptr;
+		if (InfoIndex == nullptr)
+		{
+			InfoIndex = InfosByName.Find(Entry.ParameterName);
+		}
+		if (InfoIndex == nullptr)
+		{
+			UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Verbose, TEXT("No parameter '%s' in '%s'."),
+			       *Entry.ParameterName.ToString(), *MaterialOrFunction->GetPathName());
+			continue;
+		}
+
+		FRedMaterialParameterInfo& Info = Infos[*InfoIndex];
+		const FName TypeName = GetParameterExpressionTypeName(Info.OwningMaterialExpression.Get());
+		if (TypeName != Entry.TypeName)
+		{
+			UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning,
+			       TEXT("Skipping preset entry '%s', it is a %s parameter but '%s' in '%s' is a %s parameter."),
+			       *Entry.ParameterName.ToString(), *Entry.TypeName.ToString(), *Info.ParameterName.ToString(),
+			       *MaterialOrFunction->GetPathName(), *TypeName.ToString());
+			continue;
+		}
+
+		Info.ParameterInfo.Group = Entry.Group;
+		Info.ParameterInfo.SortPriority = Entry.SortPriority;
+		ApplyGroupAndSortPriority(Info);
+		ApplyDescription(Info, Entry.Description);
+		switch (Info.ParameterType)
+		{
+		case EMaterialParameterType::Scalar:
+			{
+				ApplyScalarMinMax(Info, Entry.ScalarMin, Entry.ScalarMax);
+				ApplyDefaultValue(Info, Info.ParameterType, FMaterialParameterValue(Entry.ScalarValue));
+				UCurveLinearColor* ScalarCurve = nullptr;
+				UCurveLinearColorAtlas* ScalarAtlas = nullptr;
+				if (LoadPresetReference(Entry.ScalarCurve, Entry.ParameterName, ScalarCurve)
+					&& LoadPresetReference(Entry.ScalarAtlas, Entry.ParameterName, ScalarAtlas))
+				{
+					ApplyScalarCurveAndAtlas(Info, ScalarCurve, ScalarAtlas);
+				}
+				break;
+			}
+		case EMaterialParameterType::Vector:
+			ApplyChannelNames(Info, Entry.ChannelNames.ToParameterChannelNames());
+			ApplyDefaultValue(Info, Info.ParameterType, FMaterialParameterValue(Entry.VectorValue));
+			break;
+		case EMaterialParameterType::DoubleVector:
+			ApplyDefaultValue(Info, Info.ParameterType, FMaterialParameterValue(FVector4d(Entry.DoubleVectorValue)));
+			break;
+		case EMaterialParameterType::Texture:
+			{
+				ApplyChannelNames(Info, Entry.ChannelNames.ToParameterChannelNames());
+				UTexture* Texture = nullptr;
+				if (LoadPresetReference(Entry.TextureValue, Entry.ParameterName, Texture))
+				{
+					ApplyDefaultValue(Info, Info.ParameterType, FMaterialParameterValue(Texture));
+				}
+				break;
+			}
+		case EMaterialParameterType::StaticSwitch:
+			ApplyDefaultValue(Info, Info.ParameterType, FMaterialParameterValue(Entry.bStaticSwitchValue));
+			break;
+		case EMaterialParameterType::StaticComponentMask:
+			ApplyDefaultValue(Info, Info.ParameterType,
+			                  FMaterialParameterValue(Entry.bStaticComponentMaskR, Entry.bStaticComponentMaskG,
+			                                          Entry.bStaticComponentMaskB, Entry.bStaticComponentMaskA));
+			break;
+		default:
+			break;
+		}
+	}
+	return Batch.GetNumModifiedExpressions();
+}
+
+bool URedMaterialParameterBlueprintLibrary::SaveMaterialParameterPresetToJson(const FRedMaterialParameterPreset& Preset,
+                                                                             const FString& Filename)
+{
+	return FRedJsonStructFile::Save(Preset, Filename);
+}
+
+bool URedMaterialParameterBlueprintLibrary::LoadMaterialParameterPresetFromJson(const FString& Filename,
+                                                                               FRedMaterialParameterPreset& OutPreset)
+{
+	OutPreset = FRedMaterialParameterPreset();
+	FString Json;
+	if (!FFileHelper::LoadFileToString(Json, *Filename))
+	{
+		UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Error, TEXT("Could not read '%s'."), *Filename);
+		return false;
+	}
+	if (!FJsonObjectConverter::JsonObjectStringToUStruct(Json, &OutPreset))
+	{
+		UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Error, TEXT("'%s' is not a material parameter preset."), *Filename);
+		return false;
+	}
+	return true;
+}
+
+TArray<float> URedMaterialParameterBlueprintLibrary::GetMaterialParameterScalarDefaults(
+	const TArray<FRedMaterialParameterInfo>& Infos)
+{
+	return RedMaterialParameterEdits::GetDefaultValues<float>(
+		Infos, EMaterialParameterType::Scalar, [](const FMaterialParameterValue& Value)
+		{
+			return Value.AsScalar();
+		}, 0.0f);
+}
+
+TArray<FLinearColor> URedMaterialParameterBlueprintLibrary::GetMaterialParameterVectorDefaults(
+	const TArray<FRedMaterialParameterInfo>& Infos)
+{
+	return RedMaterialParameterEdits::GetDefaultValues<FLinearColor>(
+		Infos, EMaterialParameterType::Vector, [](const FMaterialParameterValue& Value)
+		{
+			return Value.AsLinearColor();
+		}, FLinearColor::Black);
+}
+
+TArray<UTexture*> URedMaterialParameterBlueprintLibrary::GetMaterialParameterTextureDefaults(
+	const TArray<FRedMaterialParameterInfo>& Infos)
+{
+	return RedMaterialParameterEdits::GetDefaultValues<UTexture*>(
+		Infos, EMaterialParameterType::Texture, [](const FMaterialParameterValue& Value)
+		{
+			return Value.AsTextureObject();
+		}, nullptr);
+}
+
+TArray<bool> URedMaterialParameterBlueprintLibrary::GetMaterialParameterStaticSwitchDefaults(
+	const TArray<FRedMaterialParameterInfo>& Infos)
+{
+	return RedMaterialParameterEdits::GetDefaultValues<bool>(
+		Infos, EMaterialParameterType::StaticSwitch, [](const FMaterialParameterValue& Value)
+		{
+			return Value.AsStaticSwitch();
+		}, false);
+}
+
+int32 URedMaterialParameterBlueprintLibrary::SetMaterialParameterScalarDefaults(
+	TArray<FRedMaterialParameterInfo>& Infos, const TArray<float>& Values)
+{
+	return RedMaterialParameterEdits::SetDefaultValues(Infos, Values, EMaterialParameterType::Scalar);
+}
+
+int32 URedMaterialParameterBlueprintLibrary::SetMaterialParameterVectorDefaults(
+	TArray<FRedMaterialParameterInfo>& Infos, const TArray<FLinearColor>& Values)
+{
+	return RedMaterialParameterEdits::SetDefaultValues(Infos, Values, EMaterialParameterType::Vector);
+}
+
+int32 URedMaterialParameterBlueprintLibrary::SetMaterialParameterTextureDefaults(
+	TArray<FRedMaterialParameterInfo>& Infos, const TArray<UTexture*>& Values)
+{
+	return RedMaterialParameterEdits::SetDefaultValues(Infos, Values, EMaterialParameterType::Texture);
+}
+
+int32 URedMaterialParameterBlueprintLibrary::SetMaterialParameterStaticSwitchDefaults(
+	TArray<FRedMaterialParameterInfo>& Infos, const TArray<bool>& Values)
+{
+	return RedMaterialParameterEdits::SetDefaultValues(Infos, Values, EMaterialParameterType::StaticSwitch);
+}
+
+int32 URedMaterialParameterBlueprintLibrary::RenameMaterialParameterInHierarchy(FRedMaterialParameterInfo& Info,
+                                                                              const FName NewName,
+                                                                              int32& NumFailedSaves,
+                                                                              const bool bSavePackages)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(URedMaterialParameterBlueprintLibrary::RenameMaterialParameterInHierarchy);
+
+	NumFailedSaves = 0;
+	UMaterialExpression* Expression = Info.OwningMaterialExpression.Get();
+	if (!IsValid(Expression) || NewName.IsNone())
+	{
+		return 0;
+	}
+	const FName OldName = Expression->GetParameterName();
+	UObject* Owner = GetMaterialExpression_OwningObject(Expression);
+	if (OldName == NewName || !IsValid(Owner))
+	{
+		return 0;
+	}
+
+	// Batches release what they loaded when saving, the owner has to outlive them.
+	const TStrongObjectPtr<UObject> OwnerGuard(Owner);
+
+	// Every node of the owner with the old name is the same parameter, renaming only one would split it in two.
+	TArray<UMaterialExpression*> SameNameExpressions;
+	ForEachMaterialParameterExpression(Owner, false, [&](UMaterialExpression* Other)
+	{
+		if (Other->GetParameterName() == OldName)
+		{
+			SameNameExpressions.AddUnique(Other);
+		}
+	});
+	SameNameExpressions.AddUnique(Expression);
+
+	// Parameters in functions can also be exposed through material layers, so layer overrides are renamed too.
+	const UMaterialFunctionInterface* OwningFunction = Cast<UMaterialFunctionInterface>(Owner);
+	const bool bInFunction = OwningFunction != nullptr;
+	TArray<FSoftObjectPath> Roots;
+	TArray<FSoftObjectPath> InstanceRoots;
+	if (bInFunction)
+	{
+		FRedMaterialInstanceHierarchy::FindAssetsUsingFunction(FSoftObjectPath(Owner), Roots, InstanceRoots);
+	}
+	else
+	{
+		Roots.Add(FSoftObjectPath(Owner));
+	}
+
+	// Parameters with the same name are merged, so renaming onto a name the owner, a function it calls or a
+	// material using it already has would silently join two parameters.
+	TArray<FString> Collisions;
+	auto FindCollisions = [&Collisions, &SameNameExpressions, NewName](UObject* MaterialOrFunction)
+	{
+		bool bHasNewName = false;
+		ForEachMaterialParameterExpression(MaterialOrFunction, true, [&](UMaterialExpression* Other)
+		{
+			bHasNewName |= Other->GetParameterName() == NewName && !SameNameExpressions.Contains(Other);
+		});
+		if (bHasNewName)
+		{
+			Collisions.Add(MaterialOrFunction->GetPathName());
+		}
+	};
+	FindCollisions(Owner);
+	if (bInFunction)
+	{
+		FRedMaterialInstanceHierarchy::LoadInBatches(Roots, 32, bSavePackages, [&](TConstArrayView<UObject*> Objects)
+		{
+			for (UObject* Object : Objects)
+			{
+				FindCollisions(Object);
+			}
+		});
+	}
+	if (Collisions.Num() > 0)
+	{
+		UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Error,
+		       TEXT("Can't rename '%s' to '%s', a parameter with that name already exists in: %s"),
+		       *OldName.ToString(), *NewName.ToString(), *FString::Join(Collisions, TEXT(", ")));
+		return 0;
+	}
+
+	// Instances with their own layer stack using the function are renamed along with their children, an instance
+	// can be reached both ways so each one is only kept once.
+	TArray<FSoftObjectPath> Instances = InstanceRoots;
+	TSet<FSoftObjectPath> SeenInstances(InstanceRoots);
+	Roots.Append(InstanceRoots);
+	for (FSoftObjectPath& Descendant : FRedMaterialInstanceHierarchy::FindDescendantInstances(Roots))
+	{
+		bool bAlreadySeen = false;
+		SeenInstances.Add(Descendant, &bAlreadySeen);
+		if (!bAlreadySeen)
+		{
+			Instances.Add(MoveTemp(Descendant));
+		}
+	}
+
+	{
+		FRedMaterialEditBatch Batch(LOCTEXT("RenameMaterialParameterInHierarchy", "Rename Material Parameter"));
+		for (UMaterialExpression* SameName : SameNameExpressions)
+		{
+			FRedMaterialParameterInfo SameNameInfo(SameName);
+			RedMaterialParameterEdits::ApplyName(SameNameInfo, NewName);
+		}
+		Info.ParameterName = NewName;
+	}
+	if (bSavePackages)
+	{
+		NumFailedSaves += FRedMaterialInstanceHierarchy::SavePackages({Owner->GetPackage()});
+	}
+
+	int32 NumRenamed = 0;
+	TArray<UPackage*> TouchedPackages;
+	auto RenameBatch = [&](TConstArrayView<UObject*> Objects)
+	{
+		TouchedPackages.Reset();
+		for (UObject* Object : Objects)
+		{
+			auto* Instance = Cast<UMaterialInstanceConstant>(Object);
+			if (FRedMaterialInstanceHierarchy::RenameParameterOverrides(Instance, OldName, NewName, OwningFunction))
+			{
+				TouchedPackages.Add(Instance->GetPackage());
+			}
+		}
+
+		NumRenamed += TouchedPackages.Num();
+		if (bSavePackages)
+		{
+			NumFailedSaves += FRedMaterialInstanceHierarchy::SavePackages(TouchedPackages);
+		}
+	};
+	FRedMaterialInstanceHierarchy::LoadInBatches(Instances, 32, bSavePackages, RenameBatch);
+
+	UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Display,
+	       TEXT("Renamed '%s' to '%s' in '%s', updated %d of %d material instances, %d packages failed to save."),
+	       *OldName.ToString(), *NewName.ToString(), *Owner->GetPathName(), NumRenamed, Instances.Num(),
+	       NumFailedSaves);
+	return NumRenamed;
+}
+
+FRedMaterialOverridePruneReport URedMaterialParameterBlueprintLibrary::PruneRedundantMaterialInstanceOverrides(
+	UMaterialInterface* Root, const bool bDryRun, const bool bSavePackages)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(URedMaterialParameterBlueprintLibrary::PruneRedundantMaterialInstanceOverrides);
+
+	FRedMaterialOverridePruneReport Report;
+	if (!IsValid(Root))
+	{
+		return Report;
+	}
+
+	const FSoftObjectPath RootPath(Root);
+	TArray<FSoftObjectPath> Instances;
+	if (Root->IsA<UMaterialInstanceConstant>())
+	{
+		Instances.Add(RootPath);
+	}
+	Instances.Append(FRedMaterialInstanceHierarchy::FindDescendantInstances({RootPath}));
+
+	auto GetPackageFileSize = [](const UPackage* Package)
+	{
+		const FString Filename = FPackageName::LongPackageNameToFilename(
+			Package->GetName(), FPackageName::GetAssetPackageExtension());
+		return FMath::Max<int64>(IFileManager::Get().FileSize(*Filename), 0);
+	};
+
+	const bool bSave = bSavePackages && !bDryRun;
+	TArray<UPackage*> TouchedPackages;
+	auto PruneBatch = [&](TConstArrayView<UObject*> Objects)
+	{
+		TouchedPackages.Reset();
+		for (UObject* Object : Objects)
+		{
+			auto* Instance = Cast<UMaterialInstanceConstant>(Object);
+			if (FRedMaterialInstanceHierarchy::PruneRedundantOverrides(Instance, bDryRun, Report))
+			{
+				TouchedPackages.Add(Instance->GetPackage());
+			}
+		}
+
+		if (bSave && TouchedPackages.Num() > 0)
+		{
+			int64 SizeBefore = 0;
+			for (const UPackage* Package : TouchedPackages)
+			{
+				SizeBefore += GetPackageFileSize(Package);
+			}
+			Report.NumFailedSaves += FRedMaterialInstanceHierarchy::SavePackages(TouchedPackages);
+			int64 SizeAfter = 0;
+			for (const UPackage* Package : TouchedPackages)
+			{
+				SizeAfter += GetPackageFileSize(Package);
+			}
+			Report.PackageBytesSaved += SizeBefore - SizeAfter;
+		}
+	};
+	FRedMaterialInstanceHierarchy::LoadInBatches(Instances, 32, bSave, PruneBatch);
+
+	UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Display,
+	       TEXT("%s %d overrides and %d static overrides from %d of %d instances under '%s', %d shader permutations "
+		       "and %lld package bytes saved."),
+	       bDryRun ? TEXT("Would remove") : TEXT("Removed"), Report.NumOverridesRemoved,
+	       Report.NumStaticOverridesRemoved, Report.NumInstancesChanged, Report.NumInstancesVisited,
+	       *RootPath.ToString(), Report.NumShaderPermutationsRemoved, Report.PackageBytesSaved);
+	return Report;
+}
+
+FRedMaterialPermutationReport URedMaterialParameterBlueprintLibrary::AnalyzeStaticPermutations(
+	UMaterialInterface* Material, const float SecondsPerShaderMap)
+{
+	return FRedMaterialPermutationAnalysis::Analyze(Material, SecondsPerShaderMap);
+}
+
+bool URedMaterialParameterBlueprintLibrary::ExportStaticPermutationReport(const FRedMaterialPermutationReport& Report,
+                                                                         const FString& Filename)
+{
+	return FRedMaterialPermutationAnalysis::ExportReport(Report, Filename);
+}
+
+FRedTextureMemoryReport URedMaterialParameterBlueprintLibrary::AnalyzeMaterialTextureMemory(
+	const TArray<FSoftObjectPath>& Materials, const bool bIncludeInstances, const bool bLoadUntaggedAssets)
+{
+	return FRedMaterialTextureMemory::Analyze(Materials, bIncludeInstances, bLoadUntaggedAssets);
+}
+
+bool URedMaterialParameterBlueprintLibrary::ExportTextureMemoryReport(const FRedTextureMemoryReport& Report,
+                                                                     const FString& Filename)
+{
+	return FRedMaterialTextureMemory::ExportReport(Report, Filename);
+}
+
+#undef LOCTEXT_NAMESPACE
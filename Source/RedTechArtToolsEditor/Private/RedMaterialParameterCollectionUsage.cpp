@@ -0,0 +1,253 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedMaterialParameterCollectionUsage.h"
+
+#include "RedMaterialExpressionIndex.h"
+#include "RedMaterialInstanceHierarchy.h"
+#include "RedMaterialParameterBlueprintLibrary.h"
+#include "ScopedTransaction.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialFunction.h"
+#include "Materials/MaterialParameterCollection.h"
+
+#define LOCTEXT_NAMESPACE "RedMaterialParameterCollectionUsage"
+
+namespace RedMaterialParameterCollectionUsage
+{
+	/**
+	 * True if the expressions read a parameter the collection doesn't have. Collection nodes only pick up a renamed
+	 * parameter's new name when they are loaded, so the asset's tag is out of date and its reads can't be trusted.
+	 */
+	bool HasStaleReads(const FRedCollectionUsageReport& Report, const TMap<FName, int32>& ParameterIndices,
+	                   TConstArrayView<FRedIndexedMaterialExpression> Expressions)
+	{
+		return Expressions.ContainsByPredicate([&](const FRedIndexedMaterialExpression& Expression)
+		{
+			return Expression.ReferencedAsset == Report.Collection && !Expression.ParameterName.IsNone()
+				&& !ParameterIndices.Contains(Expression.ParameterName);
+		});
+	}
+
+	void AddReads(FRedCollectionUsageReport& Report, const TMap<FName, int32>& ParameterIndices,
+	              const FSoftObjectPath& Reader, TConstArrayView<FRedIndexedMaterialExpression> Expressions)
+	{
+		for (const FRedIndexedMaterialExpression& Expression : Expressions)
+		{
+			if (Expression.ReferencedAsset != Report.Collection || Expression.ParameterName.IsNone())
+			{
+				continue;
+			}
+			if (const int32* ParameterIndex = ParameterIndices.Find(Expression.ParameterName))
+			{
+				Report.Parameters[*ParameterIndex].Readers.AddUnique(Reader);
+			}
+		}
+	}
+}
+
+FRedCollectionUsageReport FRedMaterialParameterCollectionUsage::Analyze(
+	const UMaterialParameterCollection* Collection, const bool bLoadUnindexedAssets)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialParameterCollectionUsage::Analyze);
+	using namespace RedMaterialParameterCollectionUsage;
+
+	FRedCollectionUsageReport Report;
+	if (!IsValid(Collection))
+	{
+		return Report;
+	}
+	Report.Collection = FSoftObjectPath(Collection);
+
+	TMap<FName, int32> ParameterIndices;
+	for (const FCollectionScalarParameter& Parameter : Collection->ScalarParameters)
+	{
+		ParameterIndices.Add(Parameter.ParameterName, Report.Parameters.Num());
+		Report.Parameters.AddDefaulted_GetRef().ParameterName = Parameter.ParameterName;
+	}
+	for (const FCollectionVectorParameter& Parameter : Collection->VectorParameters)
+	{
+		ParameterIndices.Add(Parameter.ParameterName, Report.Parameters.Num());
+		FRedCollectionParameterUsage& Usage = Report.Parameters.AddDefaulted_GetRef();
+		Usage.ParameterName = Parameter.ParameterName;
+		Usage.bIsVector = true;
+	}
+
+	// Collection parameter nodes hold a hard reference to the collection, so the referencers are every possible reader.
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TArray<FName> Referencers;
+	AssetRegistry.GetReferencers(Collection->GetPackage()->GetFName(), Referencers,
+	                             UE::AssetRegistry::EDependencyCategory::Package);
+
+	FRedMaterialExpressionIndex& ExpressionIndex = FRedMaterialExpressionIndex::Get();
+	TArray<FAssetData> ReferencerAssets;
+	TArray<FRedIndexedMaterialExpression> Expressions;
+	for (const FName Referencer : Referencers)
+	{
+		ReferencerAssets.Reset();
+		AssetRegistry.GetAssetsByPackageName(Referencer, ReferencerAssets);
+		for (const FAssetData& AssetData : ReferencerAssets)
+		{
+			const UClass* AssetClass = AssetData.GetClass();
+			const FSoftObjectPath Asset = AssetData.GetSoftObjectPath();
+			if (AssetClass == nullptr || !(AssetClass->IsChildOf<UMaterial>() || AssetClass->IsChildOf<UMaterialFunction>()))
+			{
+				Report.OtherReferencers.Add(Asset);
+				continue;
+			}
+
+			Expressions.Reset();
+			if (ExpressionIndex.GetAssetExpressions(Asset, Expressions)
+				&& !HasStaleReads(Report, ParameterIndices, Expressions))
+			{
+				AddReads(Report, ParameterIndices, Asset, Expressions);
+			}
+			else
+			{
+				Report.UnknownReaders.Add(Asset);
+			}
+		}
+	}
+
+	if (bLoadUnindexedAssets && Report.UnknownReaders.Num() > 0)
+	{
+		const TArray<FSoftObjectPath> UnindexedAssets = MoveTemp(Report.UnknownReaders);
+		Report.UnknownReaders.Reset();
+		TSet<FSoftObjectPath> LoadedAssets;
+		FRedMaterialInstanceHierarchy::LoadInBatches(UnindexedAssets, 64, true, [&](TConstArrayView<UObject*> Objects)
+		{
+			for (const UObject* Object : Objects)
+			{
+				const FSoftObjectPath Asset(Object);
+				LoadedAssets.Add(Asset);
+				Expressions.Reset();
+				FRedMaterialExpressionIndex::ParseExpressionsTagValue(
+					Asset, FRedMaterialExpressionIndex::MakeExpressionsTagValue(Object), Expressions);
+				AddReads(Report, ParameterIndices, Asset, Expressions);
+			}
+		});
+		Report.NumAssetsLoaded = LoadedAssets.Num();
+
+		// Anything that failed to load stays unknown.
+		for (const FSoftObjectPath& Asset : UnindexedAssets)
+		{
+			if (!LoadedAssets.Contains(Asset))
+			{
+				Report.UnknownReaders.Add(Asset);
+			}
+		}
+	}
+
+	int32 NumUnusedScalars = 0;
+	int32 NumUnusedVectors = 0;
+	for (const FRedCollectionParameterUsage& Usage : Report.Parameters)
+	{
+		if (Usage.Readers.Num() == 0)
+		{
+			Report.UnusedParameters.Add(Usage.ParameterName);
+			if (Usage.bIsVector)
+			{
+				++NumUnusedVectors;
+			}
+			else
+			{
+				++NumUnusedScalars;
+			}
+		}
+	}
+
+	const int32 NumScalars = Collection->ScalarParameters.Num();
+	const int32 NumVectors = Collection->VectorParameters.Num();
+	Report.UniformBufferBytes = GetUniformBufferBytes(NumScalars, NumVectors);
+	Report.PrunedUniformBufferBytes = GetUniformBufferBytes(NumScalars - NumUnusedScalars,
+	                                                        NumVectors - NumUnusedVectors);
+	return Report;
+}
+
+int32 FRedMaterialParameterCollectionUsage::PruneUnusedParameters(UMaterialParameterCollection* Collection,
+                                                                  const FRedCollectionUsageReport& Report,
+                                                                  const bool bIgnoreOtherReferencers)
+{
+	if (!IsValid(Collection) || Report.Collection != FSoftObjectPath(Collection))
+	{
+		UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Error, TEXT("The usage report is not for this collection."));
+		return INDEX_NONE;
+	}
+
+	if (Report.UnknownReaders.Num() > 0)
+	{
+		UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Error,
+		       TEXT("Not pruning '%s', %d referencing materials could not be checked, e.g. '%s'. Resave or load them."),
+		       *Collection->GetPathName(), Report.UnknownReaders.Num(), *Report.UnknownReaders[0].ToString());
+		return INDEX_NONE;
+	}
+
+	// Blueprints and other assets set collection parameters by name, removing one breaks them silently.
+	if (Report.OtherReferencers.Num() > 0 && !bIgnoreOtherReferencers)
+	{
+		UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Error,
+		       TEXT("Not pruning '%s', %d other assets reference it and may set the unused parameters, e.g. '%s'."),
+		       *Collection->GetPathName(), Report.OtherReferencers.Num(), *Report.OtherReferencers[0].ToString());
+		return INDEX_NONE;
+	}
+
+	if (Report.UnusedParameters.Num() == 0)
+	{
+		return 0;
+	}
+
+	const TSet<FName> Unused(Report.UnusedParameters);
+	const FScopedTransaction Transaction(LOCTEXT("PruneUnusedParameters", "Prune Unused Collection Parameters"));
+	Collection->Modify();
+
+	// The collection compares against the parameter counts it records here to tell that its layout changed.
+	Collection->PreEditChange(nullptr);
+	const int32 NumRemoved =
+		Collection->ScalarParameters.RemoveAll([&Unused](const FCollectionScalarParameter& Parameter)
+		{
+			return Unused.Contains(Parameter.ParameterName);
+		})
+		+ Collection->VectorParameters.RemoveAll([&Unused](const FCollectionVectorParameter& Parameter)
+		{
+			return Unused.Contains(Parameter.ParameterName);
+		});
+
+	// Rebuilds the uniform buffer layout and recompiles the materials using the collection.
+	Collection->PostEditChange();
+
+	if (Report.OtherReferencers.Num() > 0)
+	{
+		UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning,
+		       TEXT("Pruned '%s' although %d other assets reference it, they may still try to set the removed "
+			       "parameters."), *Collection->GetPathName(), Report.OtherReferencers.Num());
+	}
+	return NumRemoved;
+}
+
+int32 FRedMaterialParameterCollectionUsage::GetUniformBufferBytes(const int32 NumScalarParameters,
+                                                                  const int32 NumVectorParameters)
+{
+	return (FMath::DivideAndRoundUp(NumScalarParameters, 4) + NumVectorParameters) * sizeof(FVector4f);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,251 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedMaterialParameterConsistency.h"
+
+#include "RedJsonStructFile.h"
+#include "RedMaterialInstanceHierarchy.h"
+#include "RedMaterialParameterAudit.h"
+#include "RedMaterialParameterBlueprintLibrary.h"
+#include "RedMaterialParameterIndex.h"
+#include "Async/ParallelFor.h"
+
+namespace RedMaterialParameterConsistency
+{
+	const FName CollectionParameterTypeName("CollectionParameter");
+	const FName ScalarTypeName("Scalar");
+
+	/** One parameter declared in one asset. */
+	struct FDeclaration
+	{
+		FName ParameterName;
+		FName TypeName;
+		FName Group;
+		float ScalarMin = 0.0f;
+		float ScalarMax = 0.0f;
+		int32 AssetIndex = INDEX_NONE;
+		uint32 SignatureHash = 0;
+	};
+
+	uint32 HashSignature(const FDeclaration& Declaration)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(Declaration.TypeName), GetTypeHash(Declaration.Group));
+		if (Declaration.TypeName == ScalarTypeName)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Declaration.ScalarMin));
+			Hash = HashCombine(Hash, GetTypeHash(Declaration.ScalarMax));
+		}
+		return Hash;
+	}
+
+	bool HasSameSignature(const FDeclaration& Declaration, const FRedMaterialParameterSignature& Signature)
+	{
+		return Declaration.TypeName == Signature.TypeName && Declaration.Group == Signature.Group
+			&& (Declaration.TypeName != ScalarTypeName
+				|| (Declaration.ScalarMin == Signature.ScalarMin && Declaration.ScalarMax == Signature.ScalarMax));
+	}
+
+	void AddDeclaration(TArray<FDeclaration>& Declarations, const FName ParameterName, const FName TypeName,
+	                    const FName Group, const float ScalarMin, const float ScalarMax, const int32 AssetIndex)
+	{
+		if (TypeName != CollectionParameterTypeName)
+		{
+			Declarations.Add({ParameterName, TypeName, Group, ScalarMin, ScalarMax, AssetIndex});
+		}
+	}
+
+	/**
+	 * Adds the parameters declared directly in the asset from its tag. Returns false if the asset has to be loaded
+	 * instead, because it has no tag or the tag predates the slider range.
+	 */
+	bool AddTaggedDeclarations(const FAssetData& AssetData, const int32 AssetIndex,
+	                           TArray<FDeclaration>& Declarations)
+	{
+		FString TagValue;
+		if (!AssetData.GetTagValue(FRedMaterialParameterIndex::ParametersTagName, TagValue))
+		{
+			return false;
+		}
+
+		TArray<FRedIndexedMaterialParameter> Parameters;
+		if (!FRedMaterialParameterIndex::ParseParametersTagValue(AssetData.GetSoftObjectPath(), TagValue, Parameters)
+			|| Parameters.ContainsByPredicate([](const FRedIndexedMaterialParameter& Parameter)
+			{
+				return !Parameter.bHasScalarRange;
+			}))
+		{
+			return false;
+		}
+
+		// Parameters inside functions the asset uses are checked with the function itself.
+		for (const FRedIndexedMaterialParameter& Parameter : Parameters)
+		{
+			if (Parameter.OwningFunction.IsNull())
+			{
+				AddDeclaration(Declarations, Parameter.ParameterName, Parameter.TypeName, Parameter.Group,
+				               Parameter.ScalarMin, Parameter.ScalarMax, AssetIndex);
+			}
+		}
+		return true;
+	}
+}
+
+FRedMaterialParameterConsistencyReport FRedMaterialParameterConsistency::Check(const TArray<FName>& PackagePaths,
+                                                                               const bool bLoadUntaggedAssets)
+{
+	FRedMaterialParameterAuditOptions Options;
+	Options.PackagePaths = PackagePaths;
+	return Check(FRedMaterialParameterAudit::FindAssets(Options), bLoadUntaggedAssets);
+}
+
+FRedMaterialParameterConsistencyReport FRedMaterialParameterConsistency::Check(TConstArrayView<FAssetData> Assets,
+                                                                               const bool bLoadUntaggedAssets)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialParameterConsistency::Check);
+	using namespace RedMaterialParameterConsistency;
+
+	FRedMaterialParameterConsistencyReport Report;
+	Report.NumAssetsChecked = Assets.Num();
+
+	TArray<FSoftObjectPath> AssetPaths;
+	TMap<FString, int32> UntaggedAssetIndices;
+	TArray<FSoftObjectPath> UntaggedAssets;
+	TArray<FDeclaration> Declarations;
+	for (const FAssetData& AssetData : Assets)
+	{
+		const int32 AssetIndex = AssetPaths.Add(AssetData.GetSoftObjectPath());
+		if (!AddTaggedDeclarations(AssetData, AssetIndex, Declarations))
+		{
+			UntaggedAssetIndices.Add(AssetPaths[AssetIndex].ToString(), AssetIndex);
+			UntaggedAssets.Add(AssetPaths[AssetIndex]);
+		}
+	}
+
+	if (bLoadUntaggedAssets)
+	{
+		TArray<FRedMaterialParameterAuditRow> Rows;
+		FRedMaterialInstanceHierarchy::LoadInBatches(UntaggedAssets, 64, true, [&](TConstArrayView<UObject*> Objects)
+		{
+			Report.NumAssetsLoaded += Objects.Num();
+			Rows.Reset();
+			FRedMaterialParameterAudit::GatherRows(Objects, Rows);
+			for (const FRedMaterialParameterAuditRow& Row : Rows)
+			{
+				if (const int32* AssetIndex = UntaggedAssetIndices.Find(Row.Asset))
+				{
+					AddDeclaration(Declarations, Row.ParameterName, Row.TypeName, Row.Group, Row.ScalarMin,
+					               Row.ScalarMax, *AssetIndex);
+				}
+			}
+		});
+	}
+	Report.NumParametersChecked = Declarations.Num();
+
+	ParallelFor(Declarations.Num(), [&Declarations](const int32 Index)
+	{
+		Declarations[Index].SignatureHash = HashSignature(Declarations[Index]);
+	});
+
+	TMap<FName, TArray<int32>> DeclarationsByName;
+	for (int32 Index = 0; Index < Declarations.Num(); ++Index)
+	{
+		DeclarationsByName.FindOrAdd(Declarations[Index].ParameterName).Add(Index);
+	}
+
+	for (const TPair<FName, TArray<int32>>& Pair : DeclarationsByName)
+	{
+		FRedMaterialParameterConflict Conflict;
+		Conflict.ParameterName = Pair.Key;
+		TArray<uint32, TInlineAllocator<4>> SignatureHashes;
+		for (const int32 DeclarationIndex : Pair.Value)
+		{
+			const FDeclaration& Declaration = Declarations[DeclarationIndex];
+			int32 SignatureIndex = INDEX_NONE;
+			for (int32 Index = 0; Index < SignatureHashes.Num(); ++Index)
+			{
+				if (SignatureHashes[Index] == Declaration.SignatureHash
+					&& HasSameSignature(Declaration, Conflict.Signatures[Index]))
+				{
+					SignatureIndex = Index;
+					break;
+				}
+			}
+			if (SignatureIndex == INDEX_NONE)
+			{
+				FRedMaterialParameterSignature& Signature = Conflict.Signatures.AddDefaulted_GetRef();
+				Signature.TypeName = Declaration.TypeName;
+				Signature.Group = Declaration.Group;
+				Signature.ScalarMin = Declaration.ScalarMin;
+				Signature.ScalarMax = Declaration.ScalarMax;
+				SignatureIndex = SignatureHashes.Add(Declaration.SignatureHash);
+			}
+			Conflict.Signatures[SignatureIndex].Assets.AddUnique(AssetPaths[Declaration.AssetIndex]);
+		}
+
+		if (Conflict.Signatures.Num() < 2)
+		{
+			continue;
+		}
+
+		const FRedMaterialParameterSignature& First = Conflict.Signatures[0];
+		const FRedMaterialParameterSignature* FirstScalar = Conflict.Signatures.FindByPredicate(
+			[](const FRedMaterialParameterSignature& Signature)
+			{
+				return Signature.TypeName == ScalarTypeName;
+			});
+		bool bTypeDiffers = false;
+		bool bGroupDiffers = false;
+		bool bSliderRangeDiffers = false;
+		for (const FRedMaterialParameterSignature& Signature : Conflict.Signatures)
+		{
+			bTypeDiffers |= Signature.TypeName != First.TypeName;
+			bGroupDiffers |= Signature.Group != First.Group;
+			bSliderRangeDiffers |= Signature.TypeName == ScalarTypeName
+				&& (Signature.ScalarMin != FirstScalar->ScalarMin || Signature.ScalarMax != FirstScalar->ScalarMax);
+		}
+		if (bTypeDiffers)
+		{
+			Conflict.ConflictingFields.Add(FName("Type"));
+		}
+		if (bGroupDiffers)
+		{
+			Conflict.ConflictingFields.Add(FName("Group"));
+		}
+		if (bSliderRangeDiffers)
+		{
+			Conflict.ConflictingFields.Add(FName("SliderRange"));
+		}
+		Report.Conflicts.Add(MoveTemp(Conflict));
+	}
+
+	Report.Conflicts.Sort([](const FRedMaterialParameterConflict& A, const FRedMaterialParameterConflict& B)
+	{
+		return A.ParameterName.LexicalLess(B.ParameterName);
+	});
+	return Report;
+}
+
+bool FRedMaterialParameterConsistency::ExportReport(const FRedMaterialParameterConsistencyReport& Report,
+                                                    const FString& Filename)
+{
+	return FRedJsonStructFile::Save(Report, Filename);
+}
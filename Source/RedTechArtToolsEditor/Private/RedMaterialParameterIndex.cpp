@@ -0,0 +1,368 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedMaterialParameterIndex.h"
+
+#include "RedAssetRegistryTagWriter.h"
+#include "RedMaterialParameterBlueprintLibrary.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialFunction.h"
+
+const FName FRedMaterialParameterIndex::ParametersTagName = FName("RedMaterialParameters");
+
+namespace RedMaterialParameterIndex
+{
+	TUniquePtr<FRedMaterialParameterIndex> Instance;
+	FDelegateHandle TagWriterHandle;
+
+	/*
+	 * Tag format: one parameter per line, fields separated by tabs.
+	 *	Name	Type	Group	ExpressionGuid	OwningFunction	ScalarMin	ScalarMax
+	 * Readers ignore any fields past the ones they know about, so more can be appended later.
+	 */
+	constexpr TCHAR FieldSeparator = TEXT('\t');
+	constexpr TCHAR RowSeparator = TEXT('\n');
+
+	FString SanitizeField(FString Field)
+	{
+		Field.ReplaceCharInline(FieldSeparator, TEXT(' '));
+		Field.ReplaceCharInline(RowSeparator, TEXT(' '));
+		Field.ReplaceCharInline(TEXT('\r'), TEXT(' '));
+		return Field;
+	}
+}
+
+FRedMaterialParameterIndex& FRedMaterialParameterIndex::Get()
+{
+	if (!RedMaterialParameterIndex::Instance.IsValid())
+	{
+		RedMaterialParameterIndex::Instance = MakeUnique<FRedMaterialParameterIndex>();
+	}
+	return *RedMaterialParameterIndex::Instance;
+}
+
+void FRedMaterialParameterIndex::RegisterTagWriter()
+{
+	RedMaterialParameterIndex::TagWriterHandle = FRedAssetRegistryTagWriter::Register(
+		ParametersTagName,
+		[](const UObject* Object) { return Object->IsA<UMaterial>() || Object->IsA<UMaterialFunction>(); },
+		&FRedMaterialParameterIndex::MakeParametersTagValue);
+}
+
+void FRedMaterialParameterIndex::Shutdown()
+{
+	FRedAssetRegistryTagWriter::Unregister(RedMaterialParameterIndex::TagWriterHandle);
+	RedMaterialParameterIndex::Instance.Reset();
+}
+
+FRedMaterialParameterIndex::~FRedMaterialParameterIndex()
+{
+	if (IAssetRegistry* AssetRegistry = IAssetRegistry::Get())
+	{
+		AssetRegistry->OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry->OnAssetUpdated().Remove(AssetUpdatedHandle);
+		AssetRegistry->OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry->OnAssetRenamed().Remove(AssetRenamedHandle);
+		AssetRegistry->OnFilesLoaded().Remove(FilesLoadedHandle);
+	}
+}
+
+TArray<FRedIndexedMaterialParameter> FRedMaterialParameterIndex::FindByName(const FName ParameterName)
+{
+	if (!bIsBuilt)
+	{
+		BuildIndex();
+	}
+
+	TArray<FRedIndexedMaterialParameter> Result;
+	if (const TSet<FSoftObjectPath>* Assets = AssetsByParameterName.Find(ParameterName))
+	{
+		for (const FSoftObjectPath& Asset : *Assets)
+		{
+			for (const FRedIndexedMaterialParameter& Parameter : ParametersByAsset.FindChecked(Asset))
+			{
+				if (Parameter.ParameterName == ParameterName)
+				{
+					Result.Add(Parameter);
+				}
+			}
+		}
+	}
+	return Result;
+}
+
+TArray<FRedIndexedMaterialParameter> FRedMaterialParameterIndex::FindByGroup(const FName Group)
+{
+	if (!bIsBuilt)
+	{
+		BuildIndex();
+	}
+
+	TArray<FRedIndexedMaterialParameter> Result;
+	for (const TPair<FSoftObjectPath, TArray<FRedIndexedMaterialParameter>>& Pair : ParametersByAsset)
+	{
+		for (const FRedIndexedMaterialParameter& Parameter : Pair.Value)
+		{
+			if (Parameter.Group == Group)
+			{
+				Result.Add(Parameter);
+			}
+		}
+	}
+	return Result;
+}
+
+TArray<FRedIndexedMaterialParameter> FRedMaterialParameterIndex::GetParameters(const FSoftObjectPath& Asset)
+{
+	if (!bIsBuilt)
+	{
+		BuildIndex();
+	}
+
+	if (const TArray<FRedIndexedMaterialParameter>* Parameters = ParametersByAsset.Find(Asset))
+	{
+		return *Parameters;
+	}
+	return {};
+}
+
+TArray<FSoftObjectPath> FRedMaterialParameterIndex::GetUnindexedAssets()
+{
+	if (!bIsBuilt)
+	{
+		BuildIndex();
+	}
+	return UnindexedAssets.Array();
+}
+
+FString FRedMaterialParameterIndex::MakeParametersTagValue(const UObject* MaterialOrFunction)
+{
+	using namespace RedMaterialParameterIndex;
+
+	// The traversal isn't const, but nothing here modifies the material.
+	UObject* Object = const_cast<UObject*>(MaterialOrFunction);
+
+	TStringBuilder<1024> Builder;
+	URedMaterialParameterBlueprintLibrary::ForEachMaterialParameterExpression(
+		Object, true, [&Builder, MaterialOrFunction](UMaterialExpression* Expression)
+		{
+			const FRedMaterialParameterInfo Info(Expression);
+			const FName TypeName = URedMaterialParameterBlueprintLibrary::GetParameterExpressionTypeName(Expression);
+			const UObject* ExpressionFunction = Expression->Function;
+			const UObject* OwningFunction = ExpressionFunction != MaterialOrFunction ? ExpressionFunction : nullptr;
+
+			Builder << SanitizeField(Info.ParameterName.ToString()) << FieldSeparator
+				<< TypeName.ToString() << FieldSeparator
+				<< SanitizeField(Info.ParameterInfo.Group.ToString()) << FieldSeparator
+				<< Info.ParameterInfo.ExpressionGuid.ToString(EGuidFormats::Digits) << FieldSeparator
+				<< (OwningFunction != nullptr ? OwningFunction->GetPathName() : FString()) << FieldSeparator
+				<< FString::Printf(TEXT("%.9g"), Info.ParameterInfo.ScalarMin) << FieldSeparator
+				<< FString::Printf(TEXT("%.9g"), Info.ParameterInfo.ScalarMax) << RowSeparator;
+		});
+	return Builder.ToString();
+}
+
+bool FRedMaterialParameterIndex::ParseParametersTagValue(const FSoftObjectPath& Asset, const FStringView TagValue,
+                                                         TArray<FRedIndexedMaterialParameter>& OutParameters)
+{
+	using namespace RedMaterialParameterIndex;
+
+	bool bSuccess = true;
+	TArray<FStringView, TInlineAllocator<8>> Fields;
+	FStringView Remaining = TagValue;
+	while (!Remaining.IsEmpty())
+	{
+		int32 RowEnd = INDEX_NONE;
+		if (!Remaining.FindChar(RowSeparator, RowEnd))
+		{
+			RowEnd = Remaining.Len();
+		}
+		const FStringView Row = Remaining.Left(RowEnd);
+		Remaining.RightChopInline(RowEnd + 1);
+		if (Row.IsEmpty())
+		{
+			continue;
+		}
+
+		Fields.Reset();
+		FStringView RowRemaining = Row;
+		while (true)
+		{
+			int32 FieldEnd = INDEX_NONE;
+			if (!RowRemaining.FindChar(FieldSeparator, FieldEnd))
+			{
+				Fields.Add(RowRemaining);
+				break;
+			}
+			Fields.Add(RowRemaining.Left(FieldEnd));
+			RowRemaining.RightChopInline(FieldEnd + 1);
+		}
+
+		if (Fields.Num() < 5)
+		{
+			bSuccess = false;
+			continue;
+		}
+
+		FRedIndexedMaterialParameter& Parameter = OutParameters.AddDefaulted_GetRef();
+		Parameter.Asset = Asset;
+		Parameter.ParameterName = FName(Fields[0]);
+		Parameter.TypeName = FName(Fields[1]);
+		Parameter.Group = FName(Fields[2]);
+		FGuid::Parse(FString(Fields[3]), Parameter.ExpressionGuid);
+		if (!Fields[4].IsEmpty())
+		{
+			Parameter.OwningFunction = FSoftObjectPath(FString(Fields[4]));
+		}
+
+		// Tags written before the slider range was added stop at the owning function.
+		if (Fields.Num() >= 7)
+		{
+			Parameter.bHasScalarRange = LexTryParseString(Parameter.ScalarMin, *FString(Fields[5]))
+				&& LexTryParseString(Parameter.ScalarMax, *FString(Fields[6]));
+		}
+	}
+	return bSuccess;
+}
+
+bool FRedMaterialParameterIndex::IsIndexedAssetClass(const FAssetData& AssetData)
+{
+	const UClass* AssetClass = AssetData.GetClass();
+	return AssetClass != nullptr && (AssetClass->IsChildOf<UMaterial>() || AssetClass->IsChildOf<UMaterialFunction>());
+}
+
+void FRedMaterialParameterIndex::BuildIndex()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialParameterIndex::BuildIndex);
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	if (!bIsBuilt)
+	{
+		AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(
+			this, &FRedMaterialParameterIndex::HandleAssetAddedOrUpdated);
+		AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(
+			this, &FRedMaterialParameterIndex::HandleAssetAddedOrUpdated);
+		AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FRedMaterialParameterIndex::HandleAssetRemoved);
+		AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FRedMaterialParameterIndex::HandleAssetRenamed);
+		if (AssetRegistry.IsLoadingAssets())
+		{
+			// Build from what is known now, and again once the initial scan has found everything.
+			FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FRedMaterialParameterIndex::HandleFilesLoaded);
+		}
+	}
+	bIsBuilt = true;
+
+	ParametersByAsset.Reset();
+	AssetsByParameterName.Reset();
+	UnindexedAssets.Reset();
+
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UMaterial::StaticClass()->GetClassPathName());
+	Filter.ClassPaths.Add(UMaterialFunction::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+
+	AssetRegistry.EnumerateAssets(Filter, [this](const FAssetData& AssetData)
+	{
+		AddAsset(AssetData);
+		return true;
+	});
+}
+
+void FRedMaterialParameterIndex::AddAsset(const FAssetData& AssetData)
+{
+	const FSoftObjectPath Asset = AssetData.GetSoftObjectPath();
+	RemoveAsset(Asset);
+
+	FString TagValue;
+	if (!AssetData.GetTagValue(ParametersTagName, TagValue))
+	{
+		UnindexedAssets.Add(Asset);
+		return;
+	}
+
+	TArray<FRedIndexedMaterialParameter>& Parameters = ParametersByAsset.Add(Asset);
+	ParseParametersTagValue(Asset, TagValue, Parameters);
+	for (const FRedIndexedMaterialParameter& Parameter : Parameters)
+	{
+		AssetsByParameterName.FindOrAdd(Parameter.ParameterName).Add(Asset);
+	}
+}
+
+void FRedMaterialParameterIndex::RemoveAsset(const FSoftObjectPath& Asset)
+{
+	UnindexedAssets.Remove(Asset);
+
+	TArray<FRedIndexedMaterialParameter> OldParameters;
+	if (!ParametersByAsset.RemoveAndCopyValue(Asset, OldParameters))
+	{
+		return;
+	}
+
+	for (const FRedIndexedMaterialParameter& Parameter : OldParameters)
+	{
+		if (TSet<FSoftObjectPath>* Assets = AssetsByParameterName.Find(Parameter.ParameterName))
+		{
+			Assets->Remove(Asset);
+			if (Assets->Num() == 0)
+			{
+				AssetsByParameterName.Remove(Parameter.ParameterName);
+			}
+		}
+	}
+}
+
+void FRedMaterialParameterIndex::HandleAssetAddedOrUpdated(const FAssetData& AssetData)
+{
+	if (bIsBuilt && IsIndexedAssetClass(AssetData))
+	{
+		AddAsset(AssetData);
+	}
+}
+
+void FRedMaterialParameterIndex::HandleAssetRemoved(const FAssetData& AssetData)
+{
+	if (bIsBuilt)
+	{
+		RemoveAsset(AssetData.GetSoftObjectPath());
+	}
+}
+
+void FRedMaterialParameterIndex::HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	if (bIsBuilt)
+	{
+		RemoveAsset(FSoftObjectPath(OldObjectPath));
+		HandleAssetAddedOrUpdated(AssetData);
+	}
+}
+
+void FRedMaterialParameterIndex::HandleFilesLoaded()
+{
+	if (IAssetRegistry* AssetRegistry = IAssetRegistry::Get())
+	{
+		AssetRegistry->OnFilesLoaded().Remove(FilesLoadedHandle);
+	}
+	FilesLoadedHandle.Reset();
+	BuildIndex();
+}
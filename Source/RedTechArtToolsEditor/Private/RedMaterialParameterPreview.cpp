@@ -0,0 +1,266 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedMaterialParameterPreview.h"
+
+#include "RedMaterialEditBatch.h"
+#include "EditorSupportDelegates.h"
+#include "RHI.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialExpression.h"
+#include "Materials/MaterialFunctionInterface.h"
+#include "Serialization/ObjectReader.h"
+#include "Serialization/ObjectWriter.h"
+#include "UObject/UObjectIterator.h"
+
+namespace RedMaterialParameterPreview
+{
+	TUniquePtr<FRedMaterialParameterPreview> ActivePreview;
+
+	/** Parameter types whose defaults can be previewed without recompiling, other edits are applied on commit. */
+	bool IsNumericParameter(const EMaterialParameterType Type)
+	{
+		return Type == EMaterialParameterType::Scalar || Type == EMaterialParameterType::Vector
+			|| Type == EMaterialParameterType::DoubleVector;
+	}
+
+	/**
+	 * The expression's parameter as the material knows it, once for each association and index it has there. A
+	 * function used as a material layer or blend has layer or blend parameters, one per layer using it.
+	 */
+	TArray<FMaterialParameterInfo> FindParameterInfos(const UMaterial* Material, const UMaterialExpression* Expression)
+	{
+		TArray<FMaterialParameterInfo> Infos;
+		TArray<FGuid> Ids;
+		Material->GetAllParameterInfoOfType(Expression->GetParameterType(), Infos, Ids);
+
+		const FName Name = Expression->GetParameterName();
+		const FGuid Id = Expression->GetParameterExpressionId();
+		TArray<FMaterialParameterInfo> ParameterInfos;
+		for (int32 Index = 0; Index < Infos.Num(); ++Index)
+		{
+			if (Infos[Index].Name == Name && Ids[Index] == Id)
+			{
+				ParameterInfos.Add(Infos[Index]);
+			}
+		}
+		return ParameterInfos;
+	}
+}
+
+void FRedMaterialParameterPreview::Begin(const FText& Description)
+{
+	End(false);
+	RedMaterialParameterPreview::ActivePreview = MakeUnique<FRedMaterialParameterPreview>(Description);
+}
+
+int32 FRedMaterialParameterPreview::End(const bool bCommit)
+{
+	// No longer active from here on, so the commit goes through a regular edit batch.
+	const TUniquePtr<FRedMaterialParameterPreview> Preview = MoveTemp(RedMaterialParameterPreview::ActivePreview);
+	return Preview.IsValid() ? Preview->Finish(bCommit) : 0;
+}
+
+FRedMaterialParameterPreview* FRedMaterialParameterPreview::GetActive()
+{
+	return RedMaterialParameterPreview::ActivePreview.Get();
+}
+
+FRedMaterialParameterPreview::FRedMaterialParameterPreview(const FText& InDescription)
+	: Description(InDescription)
+{
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FRedMaterialParameterPreview::Tick));
+}
+
+FRedMaterialParameterPreview::~FRedMaterialParameterPreview()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+}
+
+void FRedMaterialParameterPreview::RecordExpression(UMaterialExpression* Expression)
+{
+	if (!IsValid(Expression))
+	{
+		return;
+	}
+
+	// Setters call this before every write, the new value is picked up on the next tick.
+	if (const int32* RecordIndex = RecordIndices.Find(Expression))
+	{
+		Records[*RecordIndex].bNeedsUpdate = true;
+		return;
+	}
+
+	FRecord& Record = Records.AddDefaulted_GetRef();
+	Record.Expression = Expression;
+	FObjectWriter(Expression, Record.OriginalState);
+
+	TArray<UMaterial*> Materials;
+	if (UMaterialFunctionInterface* Function = Expression->Function; IsValid(Function))
+	{
+		for (TObjectIterator<UMaterial> It; It; ++It)
+		{
+			for (const FMaterialFunctionInfo& FunctionInfo : It->GetCachedExpressionData().FunctionInfos)
+			{
+				if (FunctionInfo.Function == Function)
+				{
+					Materials.Add(*It);
+					break;
+				}
+			}
+		}
+	}
+	else if (IsValid(Expression->Material))
+	{
+		Materials.Add(Expression->Material);
+	}
+
+	if (RedMaterialParameterPreview::IsNumericParameter(Expression->GetParameterType()))
+	{
+		for (UMaterial* Material : Materials)
+		{
+			TArray<FMaterialParameterInfo> ParameterInfos =
+				RedMaterialParameterPreview::FindParameterInfos(Material, Expression);
+			if (ParameterInfos.Num() > 0)
+			{
+				Record.Materials.Add({Material, MoveTemp(ParameterInfos)});
+			}
+		}
+	}
+	RecordIndices.Add(Expression, Records.Num() - 1);
+}
+
+bool FRedMaterialParameterPreview::Tick(float DeltaTime)
+{
+	UpdatePreviewValues();
+	return true;
+}
+
+void FRedMaterialParameterPreview::UpdatePreviewValues()
+{
+	bool bUpdated = false;
+	for (FRecord& Record : Records)
+	{
+		UMaterialExpression* Expression = Record.Expression.Get();
+		if (!Record.bNeedsUpdate || Expression == nullptr)
+		{
+			continue;
+		}
+		Record.bNeedsUpdate = false;
+
+		FMaterialParameterMetadata Metadata;
+		const EMaterialParameterType Type = Expression->GetParameterType();
+		if (!RedMaterialParameterPreview::IsNumericParameter(Type) || !Expression->GetParameterValue(Metadata))
+		{
+			continue;
+		}
+
+		// Overrides the default in the material's existing uniform expressions, the shaders stay as they are.
+		for (const FMaterialUse& Use : Record.Materials)
+		{
+			UMaterial* Material = Use.Material.Get();
+			if (Material == nullptr)
+			{
+				continue;
+			}
+			for (const FMaterialParameterInfo& ParameterInfo : Use.ParameterInfos)
+			{
+				Material->OverrideNumericParameterDefault(Type, ParameterInfo, Metadata.Value.AsShaderValue(), true,
+				                                          GMaxRHIFeatureLevel);
+			}
+		}
+		bUpdated = true;
+	}
+
+	if (bUpdated)
+	{
+		FEditorSupportDelegates::RedrawAllViewports.Broadcast();
+	}
+}
+
+void FRedMaterialParameterPreview::ClearPreviewValues()
+{
+	for (const FRecord& Record : Records)
+	{
+		UMaterialExpression* Expression = Record.Expression.Get();
+		FMaterialParameterMetadata Metadata;
+		if (Expression == nullptr || !RedMaterialParameterPreview::IsNumericParameter(Expression->GetParameterType())
+			|| !Expression->GetParameterValue(Metadata))
+		{
+			continue;
+		}
+
+		for (const FMaterialUse& Use : Record.Materials)
+		{
+			UMaterial* Material = Use.Material.Get();
+			if (Material == nullptr)
+			{
+				continue;
+			}
+			for (const FMaterialParameterInfo& ParameterInfo : Use.ParameterInfos)
+			{
+				Material->OverrideNumericParameterDefault(Expression->GetParameterType(), ParameterInfo,
+				                                          Metadata.Value.AsShaderValue(), false, GMaxRHIFeatureLevel);
+			}
+		}
+	}
+}
+
+int32 FRedMaterialParameterPreview::Finish(const bool bCommit)
+{
+	ClearPreviewValues();
+
+	// Put the original state back on every expression, so a commit's transaction records the values from before the
+	// preview rather than the last previewed ones.
+	TArray<TPair<UMaterialExpression*, TArray<uint8>>> FinalStates;
+	for (FRecord& Record : Records)
+	{
+		UMaterialExpression* Expression = Record.Expression.Get();
+		if (Expression == nullptr)
+		{
+			continue;
+		}
+
+		TArray<uint8> FinalState;
+		FObjectWriter(Expression, FinalState);
+		FObjectReader(Expression, Record.OriginalState);
+		if (bCommit && FinalState != Record.OriginalState)
+		{
+			FinalStates.Emplace(Expression, MoveTemp(FinalState));
+		}
+	}
+
+	if (FinalStates.Num() == 0)
+	{
+		FEditorSupportDelegates::RedrawAllViewports.Broadcast();
+		return 0;
+	}
+
+	FRedMaterialEditBatch Batch(Description);
+	for (TPair<UMaterialExpression*, TArray<uint8>>& FinalState : FinalStates)
+	{
+		FRedMaterialEditBatch::ModifyExpression(FinalState.Key);
+		FObjectReader(FinalState.Key, FinalState.Value);
+	}
+	return FinalStates.Num();
+}
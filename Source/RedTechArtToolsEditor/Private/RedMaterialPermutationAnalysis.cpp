@@ -0,0 +1,239 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedMaterialPermutationAnalysis.h"
+
+#include "RedJsonStructFile.h"
+#include "RedMaterialInstanceHierarchy.h"
+#include "RedMaterialParameterBlueprintLibrary.h"
+#include "Async/ParallelFor.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstanceConstant.h"
+
+namespace RedMaterialPermutationAnalysis
+{
+	/**
+	 * One static parameter value per column, switch values as 0 or 1 and component masks as RGBA bits, MissingValue
+	 * where the material doesn't have the parameter. The last bytes hold a hash of the base property overrides.
+	 */
+	using FCombination = TArray<uint8>;
+
+	constexpr uint8 MissingValue = 0xFF;
+	constexpr int32 NumBasePropertyBytes = sizeof(uint32);
+
+	struct FColumn
+	{
+		FMaterialParameterInfo ParameterInfo;
+		EMaterialParameterType Type = EMaterialParameterType::StaticSwitch;
+		int32 NumOverridingInstances = 0;
+	};
+
+	struct FGatheredCombination
+	{
+		TArray<TPair<int32, uint8>> Values;
+		uint32 BasePropertiesHash = 0;
+	};
+
+	struct FAnalysisState
+	{
+		TArray<FColumn> Columns;
+		TMap<FMaterialParameterInfo, int32> ColumnIndices;
+		TArray<FGatheredCombination> Combinations;
+
+		int32 FindOrAddColumn(const FMaterialParameterInfo& ParameterInfo, const EMaterialParameterType Type)
+		{
+			if (const int32* Index = ColumnIndices.Find(ParameterInfo))
+			{
+				return *Index;
+			}
+			const int32 Index = Columns.Add({ParameterInfo, Type});
+			ColumnIndices.Add(ParameterInfo, Index);
+			return Index;
+		}
+	};
+
+	uint8 EncodeValue(const FMaterialParameterValue& Value, const EMaterialParameterType Type)
+	{
+		if (Type == EMaterialParameterType::StaticSwitch)
+		{
+			return Value.Bool[0] ? 1 : 0;
+		}
+		return (Value.Bool[0] ? 1 : 0) | (Value.Bool[1] ? 2 : 0) | (Value.Bool[2] ? 4 : 0) | (Value.Bool[3] ? 8 : 0);
+	}
+
+	/** The base properties an instance can override, each set of overrides compiles its own shaders. */
+	uint32 HashBaseProperties(const UMaterialInterface* Material)
+	{
+		uint32 Hash = GetTypeHash(static_cast<int32>(Material->GetBlendMode()));
+		Hash = HashCombine(Hash, GetTypeHash(Material->IsTwoSided()));
+		Hash = HashCombine(Hash, GetTypeHash(Material->IsDitheredLODTransition()));
+		Hash = HashCombine(Hash, GetTypeHash(Material->GetOpacityMaskClipValue()));
+		Hash = HashCombine(Hash, GetTypeHash(Material->GetShadingModels().GetShadingModelField()));
+		return Hash;
+	}
+
+	void GatherCombination(const UMaterialInterface* Material, FAnalysisState& State)
+	{
+		FGatheredCombination& Combination = State.Combinations.AddDefaulted_GetRef();
+		Combination.BasePropertiesHash = HashBaseProperties(Material);
+		constexpr EMaterialParameterType StaticTypes[] = {
+			EMaterialParameterType::StaticSwitch, EMaterialParameterType::StaticComponentMask
+		};
+		for (const EMaterialParameterType Type : StaticTypes)
+		{
+			TMap<FMaterialParameterInfo, FMaterialParameterMetadata> Parameters;
+			Material->GetAllParametersOfType(Type, Parameters);
+			for (const TPair<FMaterialParameterInfo, FMaterialParameterMetadata>& Parameter : Parameters)
+			{
+				Combination.Values.Emplace(State.FindOrAddColumn(Parameter.Key, Type),
+				                           EncodeValue(Parameter.Value.Value, Type));
+			}
+		}
+	}
+
+	void CountOverrides(const UMaterialInstanceConstant* Instance, FAnalysisState& State)
+	{
+		const FStaticParameterSet& StaticParameters = Instance->GetStaticParameters();
+		for (const FStaticSwitchParameter& Parameter : StaticParameters.StaticSwitchParameters)
+		{
+			if (Parameter.bOverride)
+			{
+				State.Columns[State.FindOrAddColumn(Parameter.ParameterInfo, EMaterialParameterType::StaticSwitch)]
+				     .NumOverridingInstances++;
+			}
+		}
+		for (const FStaticComponentMaskParameter& Parameter : StaticParameters.EditorOnly.StaticComponentMaskParameters)
+		{
+			if (Parameter.bOverride)
+			{
+				State.Columns[State.FindOrAddColumn(Parameter.ParameterInfo,
+				                                    EMaterialParameterType::StaticComponentMask)]
+				     .NumOverridingInstances++;
+			}
+		}
+	}
+
+	FCombination MakeDenseCombination(const FGatheredCombination& Gathered, const int32 NumColumns)
+	{
+		FCombination Combination;
+		Combination.Init(MissingValue, NumColumns + NumBasePropertyBytes);
+		for (const TPair<int32, uint8>& Value : Gathered.Values)
+		{
+			Combination[Value.Key] = Value.Value;
+		}
+		FMemory::Memcpy(&Combination[NumColumns], &Gathered.BasePropertiesHash, NumBasePropertyBytes);
+		return Combination;
+	}
+}
+
+FRedMaterialPermutationReport FRedMaterialPermutationAnalysis::Analyze(UMaterialInterface* Material,
+                                                                       const float SecondsPerShaderMap)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialPermutationAnalysis::Analyze);
+	using namespace RedMaterialPermutationAnalysis;
+
+	FRedMaterialPermutationReport Report;
+	UMaterial* BaseMaterial = IsValid(Material) ? Material->GetBaseMaterial() : nullptr;
+	if (BaseMaterial == nullptr)
+	{
+		return Report;
+	}
+	Report.Material = FSoftObjectPath(BaseMaterial);
+
+	FAnalysisState State;
+	GatherCombination(BaseMaterial, State);
+
+	// Only the values are kept, so the instances can be released between batches.
+	const TArray<FSoftObjectPath> Instances = FRedMaterialInstanceHierarchy::FindDescendantInstances({Report.Material});
+	FRedMaterialInstanceHierarchy::LoadInBatches(Instances, 64, true, [&](TConstArrayView<UObject*> Objects)
+	{
+		for (UObject* Object : Objects)
+		{
+			const auto* Instance = Cast<UMaterialInstanceConstant>(Object);
+			if (Instance == nullptr)
+			{
+				continue;
+			}
+
+			++Report.NumInstances;
+			CountOverrides(Instance, State);
+			if (Instance->bHasStaticPermutationResource)
+			{
+				++Report.NumInstancesWithStaticPermutation;
+				GatherCombination(Instance, State);
+			}
+		}
+	});
+
+	const int32 NumColumns = State.Columns.Num();
+	TSet<FCombination> Distinct;
+	for (const FGatheredCombination& Gathered : State.Combinations)
+	{
+		Distinct.Add(MakeDenseCombination(Gathered, NumColumns));
+	}
+	const TArray<FCombination> DistinctCombinations = Distinct.Array();
+
+	Report.NumDistinctCombinations = DistinctCombinations.Num();
+	Report.EstimatedShaderMaps = DistinctCombinations.Num();
+	Report.EstimatedCompileSeconds = Report.EstimatedShaderMaps * SecondsPerShaderMap;
+
+	// A parameter's cost is how many combinations merge when its column is ignored.
+	Report.Parameters.SetNum(NumColumns);
+	ParallelFor(NumColumns, [&](const int32 ColumnIndex)
+	{
+		TSet<FCombination> Masked;
+		TSet<uint8> Values;
+		for (FCombination Combination : DistinctCombinations)
+		{
+			Values.Add(Combination[ColumnIndex]);
+			Combination[ColumnIndex] = MissingValue;
+			Masked.Add(MoveTemp(Combination));
+		}
+
+		const FColumn& Column = State.Columns[ColumnIndex];
+		FRedStaticParameterCost& Cost = Report.Parameters[ColumnIndex];
+		Cost.ParameterName = Column.ParameterInfo.Name;
+		Cost.TypeName = Column.Type == EMaterialParameterType::StaticSwitch
+			                ? FName("StaticSwitch")
+			                : FName("StaticComponentMask");
+		Cost.LayerIndex = Column.ParameterInfo.Index;
+		Cost.NumOverridingInstances = Column.NumOverridingInstances;
+		Cost.NumDistinctValues = Values.Num();
+		Cost.NumPermutationsContributed = DistinctCombinations.Num() - Masked.Num();
+	});
+
+	Report.Parameters.Sort([](const FRedStaticParameterCost& A, const FRedStaticParameterCost& B)
+	{
+		if (A.NumPermutationsContributed != B.NumPermutationsContributed)
+		{
+			return A.NumPermutationsContributed > B.NumPermutationsContributed;
+		}
+		return A.NumOverridingInstances > B.NumOverridingInstances;
+	});
+	return Report;
+}
+
+bool FRedMaterialPermutationAnalysis::ExportReport(const FRedMaterialPermutationReport& Report,
+                                                   const FString& Filename)
+{
+	return FRedJsonStructFile::Save(Report, Filename);
+}
@@ -0,0 +1,486 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RedMaterialTextureMemory.h"
+
+#include "RedAssetRegistryTagWriter.h"
+#include "RedJsonStructFile.h"
+#include "RedMaterialExpressionIndex.h"
+#include "RedMaterialInstanceHierarchy.h"
+#include "RedMaterialParameterBlueprintLibrary.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+#include "DeviceProfiles/DeviceProfile.h"
+#include "DeviceProfiles/DeviceProfileManager.h"
+#include "EditorFramework/AssetImportData.h"
+#include "Engine/TextureCube.h"
+#include "Engine/TextureLODSettings.h"
+#include "Materials/MaterialInstance.h"
+#include "Misc/PackageName.h"
+
+const FName FRedMaterialTextureMemory::TextureOverridesTagName = FName("RedTextureOverrides");
+
+namespace RedMaterialTextureMemory
+{
+	FDelegateHandle TagWriterHandle;
+
+	// Tag format: one override per line, the parameter name and the texture path separated by a tab.
+	constexpr TCHAR FieldSeparator = TEXT('\t');
+	constexpr TCHAR RowSeparator = TEXT('\n');
+
+	using FOverrides = TArray<TPair<FName, FSoftObjectPath>>;
+
+	void ParseTextureOverrides(const FStringView TagValue, FOverrides& OutOverrides)
+	{
+		FStringView Remaining = TagValue;
+		while (!Remaining.IsEmpty())
+		{
+			int32 RowEnd = INDEX_NONE;
+			if (!Remaining.FindChar(RowSeparator, RowEnd))
+			{
+				RowEnd = Remaining.Len();
+			}
+			const FStringView Row = Remaining.Left(RowEnd);
+			Remaining.RightChopInline(RowEnd + 1);
+
+			int32 FieldEnd = INDEX_NONE;
+			if (Row.FindChar(FieldSeparator, FieldEnd))
+			{
+				OutOverrides.Emplace(FName(Row.Left(FieldEnd)), FSoftObjectPath(FString(Row.RightChop(FieldEnd + 1))));
+			}
+		}
+	}
+
+	/**
+	 * Adds the textures the asset and the functions it calls reference, following function calls through Expressions.
+	 * Assets Expressions can't provide are added to OutMissing.
+	 */
+	void CollectTextures(const FSoftObjectPath& Material,
+	                     TFunctionRef<const TArray<FRedIndexedMaterialExpression>*(const FSoftObjectPath&)> Expressions,
+	                     TArray<FRedMaterialTextureUse>& OutUses, TArray<FSoftObjectPath>& OutMissing)
+	{
+		TArray<FSoftObjectPath> PendingAssets = {Material};
+		TSet<FSoftObjectPath> VisitedAssets(PendingAssets);
+		while (PendingAssets.Num() > 0)
+		{
+			const FSoftObjectPath Asset = PendingAssets.Pop();
+			const TArray<FRedIndexedMaterialExpression>* AssetExpressions = Expressions(Asset);
+			if (AssetExpressions == nullptr)
+			{
+				OutMissing.AddUnique(Asset);
+				continue;
+			}
+
+			for (const FRedIndexedMaterialExpression& Expression : *AssetExpressions)
+			{
+				if (Expression.ReferencedAsset.IsNull())
+				{
+					continue;
+				}
+				if (Expression.ReferenceType == FName("Texture"))
+				{
+					FRedMaterialTextureUse& Use = OutUses.AddDefaulted_GetRef();
+					Use.ParameterName = Expression.ParameterName;
+					Use.Texture = Expression.ReferencedAsset;
+				}
+				else if (Expression.ReferenceType == FName("Function"))
+				{
+					bool bAlreadyVisited = false;
+					VisitedAssets.Add(Expression.ReferencedAsset, &bAlreadyVisited);
+					if (!bAlreadyVisited)
+					{
+						PendingAssets.Add(Expression.ReferencedAsset);
+					}
+				}
+			}
+		}
+	}
+
+	struct FTextureAsset
+	{
+		FAssetData AssetData;
+		int32 NumFaces = 1;
+	};
+
+	/** Bytes of a full mip chain starting at the given size. */
+	int64 GetMipChainBytes(int32 Width, int32 Height, const int32 NumMips, const FPixelFormatInfo& Format)
+	{
+		const int32 BlockSizeX = FMath::Max(Format.BlockSizeX, 1);
+		const int32 BlockSizeY = FMath::Max(Format.BlockSizeY, 1);
+		int64 Bytes = 0;
+		for (int32 Mip = 0; Mip < NumMips; ++Mip)
+		{
+			Bytes += static_cast<int64>(FMath::DivideAndRoundUp(Width, BlockSizeX))
+				* FMath::DivideAndRoundUp(Height, BlockSizeY) * Format.BlockBytes;
+			Width = FMath::Max(Width / 2, 1);
+			Height = FMath::Max(Height / 2, 1);
+		}
+		return Bytes;
+	}
+
+	FRedTextureMemoryInfo MakeTextureInfo(const FTextureAsset& TextureAsset, const FSoftObjectPath& Texture,
+	                                      const TMap<FName, EPixelFormat>& PixelFormats,
+	                                      const UTextureLODSettings* LODSettings)
+	{
+		FRedTextureMemoryInfo Info;
+		Info.Texture = Texture;
+
+		const FAssetData& AssetData = TextureAsset.AssetData;
+		FString SourceData;
+		if (AssetData.GetTagValue(UObject::SourceFileTagName(), SourceData))
+		{
+			const TOptional<FAssetImportInfo> ImportInfo = FAssetImportInfo::FromJson(SourceData);
+			if (ImportInfo.IsSet() && ImportInfo->SourceFiles.Num() > 0 && ImportInfo->SourceFiles[0].FileHash.IsValid())
+			{
+				Info.SourceFileHash = LexToString(ImportInfo->SourceFiles[0].FileHash);
+			}
+		}
+
+		FString Dimensions;
+		FString Format;
+		if (!AssetData.GetTagValue(FName("Dimensions"), Dimensions) || !AssetData.GetTagValue(FName("Format"), Format))
+		{
+			return Info;
+		}
+
+		// Dimensions are WxH, or WxHxD for volume textures.
+		TArray<FString> Sizes;
+		Dimensions.ParseIntoArray(Sizes, TEXT("x"));
+		if (Sizes.Num() < 2)
+		{
+			return Info;
+		}
+		Info.Width = FCString::Atoi(*Sizes[0]);
+		Info.Height = FCString::Atoi(*Sizes[1]);
+		const int32 Depth = Sizes.IsValidIndex(2) ? FMath::Max(FCString::Atoi(*Sizes[2]), 1) : 1;
+		Format.RemoveFromStart(TEXT("PF_"));
+		Info.Format = FName(Format);
+		const EPixelFormat* PixelFormat = PixelFormats.Find(Info.Format);
+		if (Info.Width <= 0 || Info.Height <= 0 || PixelFormat == nullptr)
+		{
+			return Info;
+		}
+		Info.bHasSizeTags = true;
+
+		int32 LODBias = 0;
+		int32 MaxLODSize = 0;
+		FString LODGroup;
+		if (AssetData.GetTagValue(FName("LODGroup"), LODGroup))
+		{
+			Info.LODGroup = FName(LODGroup);
+			const int64 GroupValue = StaticEnum<TextureGroup>()->GetValueByNameString(LODGroup);
+			if (LODSettings != nullptr && GroupValue != INDEX_NONE)
+			{
+				const FTextureLODGroup& Group = LODSettings->GetTextureLODGroup(static_cast<TextureGroup>(GroupValue));
+				LODBias = FMath::Max(Group.LODBias, 0);
+				MaxLODSize = Group.MaxLODSize;
+			}
+		}
+
+		// Mips dropped for the LOD bias, then as many more as it takes to fit the group's maximum size.
+		const int32 NumMips = FMath::FloorLog2(FMath::Max(Info.Width, Info.Height)) + 1;
+		int32 FirstMip = FMath::Min(LODBias, NumMips - 1);
+		while (MaxLODSize > 0 && FirstMip < NumMips - 1
+			&& (FMath::Max(Info.Width, Info.Height) >> FirstMip) > MaxLODSize)
+		{
+			++FirstMip;
+		}
+		Info.ResidentWidth = FMath::Max(Info.Width >> FirstMip, 1);
+		Info.ResidentHeight = FMath::Max(Info.Height >> FirstMip, 1);
+		Info.NumResidentMips = NumMips - FirstMip;
+		Info.ResidentBytes = GetMipChainBytes(Info.ResidentWidth, Info.ResidentHeight, Info.NumResidentMips,
+		                                      GPixelFormats[*PixelFormat]) * Depth * TextureAsset.NumFaces;
+		return Info;
+	}
+}
+
+void FRedMaterialTextureMemory::RegisterTagWriter()
+{
+	RedMaterialTextureMemory::TagWriterHandle = FRedAssetRegistryTagWriter::Register(
+		TextureOverridesTagName, [](const UObject* Object) { return Object->IsA<UMaterialInstance>(); },
+		&FRedMaterialTextureMemory::MakeTextureOverridesTagValue);
+}
+
+void FRedMaterialTextureMemory::Shutdown()
+{
+	FRedAssetRegistryTagWriter::Unregister(RedMaterialTextureMemory::TagWriterHandle);
+}
+
+FString FRedMaterialTextureMemory::MakeTextureOverridesTagValue(const UObject* MaterialInstance)
+{
+	using namespace RedMaterialTextureMemory;
+
+	TStringBuilder<1024> Builder;
+	if (const UMaterialInstance* Instance = Cast<UMaterialInstance>(MaterialInstance))
+	{
+		// Layer parameters can't be matched by name alone, only global overrides are recorded.
+		for (const FTextureParameterValue& Value : Instance->TextureParameterValues)
+		{
+			if (Value.ParameterValue != nullptr
+				&& Value.ParameterInfo.Association == EMaterialParameterAssociation::GlobalParameter)
+			{
+				Builder << Value.ParameterInfo.Name << FieldSeparator << Value.ParameterValue->GetPathName()
+					<< RowSeparator;
+			}
+		}
+	}
+	return Builder.ToString();
+}
+
+FRedTextureMemoryReport FRedMaterialTextureMemory::Analyze(TConstArrayView<FSoftObjectPath> Materials,
+                                                           const bool bIncludeInstances,
+                                                           const bool bLoadUntaggedAssets)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedMaterialTextureMemory::Analyze);
+	using namespace RedMaterialTextureMemory;
+
+	FRedTextureMemoryReport Report;
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	// Default textures, from the expression index or from loading the assets it doesn't have.
+	FRedMaterialExpressionIndex& ExpressionIndex = FRedMaterialExpressionIndex::Get();
+	TMap<FSoftObjectPath, TArray<FRedIndexedMaterialExpression>> ExpressionsByAsset;
+	auto GetExpressions = [&](const FSoftObjectPath& Asset) -> const TArray<FRedIndexedMaterialExpression>*
+	{
+		if (const TArray<FRedIndexedMaterialExpression>* Expressions = ExpressionsByAsset.Find(Asset))
+		{
+			return Expressions;
+		}
+		TArray<FRedIndexedMaterialExpression> Expressions;
+		if (!ExpressionIndex.GetAssetExpressions(Asset, Expressions))
+		{
+			return nullptr;
+		}
+		return &ExpressionsByAsset.Add(Asset, MoveTemp(Expressions));
+	};
+
+	TArray<FSoftObjectPath> MissingAssets;
+	while (true)
+	{
+		Report.Materials.Reset();
+		MissingAssets.Reset();
+		for (const FSoftObjectPath& Material : Materials)
+		{
+			FRedMaterialTextureMemoryEntry& Entry = Report.Materials.AddDefaulted_GetRef();
+			Entry.Asset = Material;
+			CollectTextures(Material, GetExpressions, Entry.Textures, MissingAssets);
+		}
+		if (!bLoadUntaggedAssets || MissingAssets.Num() == 0)
+		{
+			break;
+		}
+
+		// Loaded assets can call more unindexed functions, so go again until everything is known. Assets that fail to
+		// load are cached empty so they are only tried once.
+		for (const FSoftObjectPath& Asset : MissingAssets)
+		{
+			ExpressionsByAsset.Add(Asset);
+		}
+		FRedMaterialInstanceHierarchy::LoadInBatches(MissingAssets, 64, true, [&](TConstArrayView<UObject*> Objects)
+		{
+			Report.NumAssetsLoaded += Objects.Num();
+			for (const UObject* Object : Objects)
+			{
+				const FSoftObjectPath Asset(Object);
+				FRedMaterialExpressionIndex::ParseExpressionsTagValue(
+					Asset, FRedMaterialExpressionIndex::MakeExpressionsTagValue(Object),
+					ExpressionsByAsset.FindOrAdd(Asset));
+			}
+		});
+	}
+	for (const FSoftObjectPath& Asset : MissingAssets)
+	{
+		UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning, TEXT("'%s' is not indexed, its textures are left out."),
+		       *Asset.ToString());
+	}
+
+	// Instances start from their parent's textures and replace the ones they override.
+	if (bIncludeInstances)
+	{
+		TArray<FSoftObjectPath> Instances = FRedMaterialInstanceHierarchy::FindDescendantInstances(Materials);
+		TMap<FSoftObjectPath, FSoftObjectPath> Parents;
+		TMap<FSoftObjectPath, FOverrides> OverridesByInstance;
+		TArray<FSoftObjectPath> UntaggedInstances;
+		for (const FSoftObjectPath& Instance : Instances)
+		{
+			const FAssetData AssetData = AssetRegistry.GetAssetByObjectPath(Instance);
+			FString ParentPath;
+			if (AssetData.GetTagValue(FName("Parent"), ParentPath))
+			{
+				Parents.Add(Instance, FSoftObjectPath(FPackageName::ExportTextPathToObjectPath(ParentPath)));
+			}
+
+			FString TagValue;
+			if (AssetData.GetTagValue(TextureOverridesTagName, TagValue))
+			{
+				ParseTextureOverrides(TagValue, OverridesByInstance.Add(Instance));
+			}
+			else
+			{
+				UntaggedInstances.Add(Instance);
+			}
+		}
+
+		if (bLoadUntaggedAssets)
+		{
+			FRedMaterialInstanceHierarchy::LoadInBatches(UntaggedInstances, 64, true, [&](TConstArrayView<UObject*> Objects)
+			{
+				Report.NumAssetsLoaded += Objects.Num();
+				for (const UObject* Object : Objects)
+				{
+					ParseTextureOverrides(MakeTextureOverridesTagValue(Object),
+					                      OverridesByInstance.Add(FSoftObjectPath(Object)));
+				}
+			});
+		}
+
+		TMap<FSoftObjectPath, int32> EntryIndices;
+		for (int32 Index = 0; Index < Report.Materials.Num(); ++Index)
+		{
+			EntryIndices.Add(Report.Materials[Index].Asset, Index);
+		}
+		for (const FSoftObjectPath& Instance : Instances)
+		{
+			const FSoftObjectPath* Parent = Parents.Find(Instance);
+			const int32* ParentIndex = Parent != nullptr ? EntryIndices.Find(*Parent) : nullptr;
+			const FOverrides* Overrides = OverridesByInstance.Find(Instance);
+			if (ParentIndex == nullptr || Overrides == nullptr)
+			{
+				UE_LOG(LogRedTechArtToolsBlueprintEditorLib, Warning,
+				       TEXT("'%s' has no texture override tag or known parent, it is left out."), *Instance.ToString());
+				continue;
+			}
+
+			FRedMaterialTextureMemoryEntry Entry;
+			Entry.Asset = Instance;
+			Entry.Parent = *Parent;
+			Entry.Textures = Report.Materials[*ParentIndex].Textures;
+			for (FRedMaterialTextureUse& Use : Entry.Textures)
+			{
+				Use.bIsOverride = false;
+				for (const TPair<FName, FSoftObjectPath>& Override : *Overrides)
+				{
+					if (!Use.ParameterName.IsNone() && Use.ParameterName == Override.Key)
+					{
+						Use.Texture = Override.Value;
+						Use.bIsOverride = true;
+					}
+				}
+			}
+			EntryIndices.Add(Instance, Report.Materials.Add(MoveTemp(Entry)));
+		}
+	}
+
+	// Everything from here on only reads asset registry data that has already been fetched, so it runs in parallel.
+	TMap<FSoftObjectPath, int32> TextureIndices;
+	TArray<FSoftObjectPath> Textures;
+	for (const FRedMaterialTextureMemoryEntry& Entry : Report.Materials)
+	{
+		for (const FRedMaterialTextureUse& Use : Entry.Textures)
+		{
+			if (!TextureIndices.Contains(Use.Texture))
+			{
+				TextureIndices.Add(Use.Texture, Textures.Add(Use.Texture));
+			}
+		}
+	}
+
+	TArray<FTextureAsset> TextureAssets;
+	TextureAssets.SetNum(Textures.Num());
+	for (int32 Index = 0; Index < Textures.Num(); ++Index)
+	{
+		TextureAssets[Index].AssetData = AssetRegistry.GetAssetByObjectPath(Textures[Index]);
+		const UClass* TextureClass = TextureAssets[Index].AssetData.GetClass();
+		TextureAssets[Index].NumFaces = TextureClass != nullptr && TextureClass->IsChildOf<UTextureCube>() ? 6 : 1;
+	}
+
+	TMap<FName, EPixelFormat> PixelFormats;
+	for (int32 Format = 0; Format < PF_MAX; ++Format)
+	{
+		PixelFormats.Add(FName(GPixelFormats[Format].Name), static_cast<EPixelFormat>(Format));
+	}
+
+	const UDeviceProfile* DeviceProfile = UDeviceProfileManager::Get().GetActiveProfile();
+	const UTextureLODSettings* LODSettings = DeviceProfile != nullptr ? DeviceProfile->GetTextureLODSettings() : nullptr;
+	Report.DeviceProfile = DeviceProfile != nullptr ? DeviceProfile->GetName() : FString();
+
+	Report.Textures.SetNum(Textures.Num());
+	ParallelFor(Textures.Num(), [&](const int32 Index)
+	{
+		Report.Textures[Index] = MakeTextureInfo(TextureAssets[Index], Textures[Index], PixelFormats, LODSettings);
+	});
+
+	ParallelFor(Report.Materials.Num(), [&Report, &TextureIndices](const int32 Index)
+	{
+		FRedMaterialTextureMemoryEntry& Entry = Report.Materials[Index];
+		TSet<int32, DefaultKeyFuncs<int32>, TInlineSetAllocator<32>> UniqueTextures;
+		for (const FRedMaterialTextureUse& Use : Entry.Textures)
+		{
+			UniqueTextures.Add(TextureIndices.FindChecked(Use.Texture));
+		}
+		Entry.NumUniqueTextures = UniqueTextures.Num();
+		for (const int32 TextureIndex : UniqueTextures)
+		{
+			Entry.ResidentBytes += Report.Textures[TextureIndex].ResidentBytes;
+		}
+	});
+
+	TMap<FString, TArray<int32>> TexturesBySource;
+	for (int32 Index = 0; Index < Report.Textures.Num(); ++Index)
+	{
+		if (!Report.Textures[Index].SourceFileHash.IsEmpty())
+		{
+			TexturesBySource.FindOrAdd(Report.Textures[Index].SourceFileHash).Add(Index);
+		}
+	}
+	for (const TPair<FString, TArray<int32>>& Pair : TexturesBySource)
+	{
+		if (Pair.Value.Num() < 2)
+		{
+			continue;
+		}
+		FRedDuplicatedTextures& Duplicate = Report.Duplicates.AddDefaulted_GetRef();
+		Duplicate.SourceFileHash = Pair.Key;
+		int64 LargestBytes = 0;
+		for (const int32 Index : Pair.Value)
+		{
+			Duplicate.Textures.Add(Report.Textures[Index].Texture);
+			Duplicate.DuplicatedBytes += Report.Textures[Index].ResidentBytes;
+			LargestBytes = FMath::Max(LargestBytes, Report.Textures[Index].ResidentBytes);
+		}
+		Duplicate.DuplicatedBytes -= LargestBytes;
+	}
+	Report.Duplicates.Sort([](const FRedDuplicatedTextures& A, const FRedDuplicatedTextures& B)
+	{
+		return A.DuplicatedBytes > B.DuplicatedBytes;
+	});
+	Report.Textures.Sort([](const FRedTextureMemoryInfo& A, const FRedTextureMemoryInfo& B)
+	{
+		return A.ResidentBytes > B.ResidentBytes;
+	});
+	return Report;
+}
+
+bool FRedMaterialTextureMemory::ExportReport(const FRedTextureMemoryReport& Report, const FString& Filename)
+{
+	return FRedJsonStructFile::Save(Report, Filename);
+}
@@ -62,18 +62,10 @@ FString URedTechArtToolsBlueprintLibrary::GetTableAsString(const UDataTable* Dat
 FString URedTechArtToolsBlueprintLibrary::GetTableAsCSV(const UDataTable* DataTable,
                                                         const bool bUseJsonObjectsForStructs, const bool bUseSimpleText)
 {
-	if (IsValid(DataTable))
-	{
-		EDataTableExportFlags Flags = EDataTableExportFlags::None;
-		if (bUseJsonObjectsForStructs)
-			Flags = EDataTableExportFlags::UseJsonObjectsForStructs;
-
-		if (bUseSimpleText)
-			Flags = Flags | EDataTableExportFlags::UseSimpleText;
-
-		return DataTable->GetTableAsString(Flags);
-	}
-	return "";
+	FRedDataTableExportOptions Options;
+	Options.bUseJsonObjectsForStructs = bUseJsonObjectsForStructs;
+	Options.bUseSimpleText = bUseSimpleText;
+	return FRedDataTableExport::ExportToString(DataTable, ERedDataTableFormat::Csv, Options);
 }
 
 
@@ -82,18 +74,43 @@ FString URedTechArtToolsBlueprintLibrary::GetTableAsJSON(const UDataTable* DataT
                                                          const bool bUseJsonObjectsForStructs,
                                                          const bool bUseSimpleText)
 {
-	if (IsValid(DataTable))
-	{
-		EDataTableExportFlags Flags = EDataTableExportFlags::None;
-		if (bUseJsonObjectsForStructs)
-			Flags = EDataTableExportFlags::UseJsonObjectsForStructs;
+	FRedDataTableExportOptions Options;
+	Options.bUseJsonObjectsForStructs = bUseJsonObjectsForStructs;
+	Options.bUseSimpleText = bUseSimpleText;
+	return FRedDataTableExport::ExportToString(DataTable, ERedDataTableFormat::Json, Options);
+}
 
-		if (bUseSimpleText)
-			Flags = Flags | EDataTableExportFlags::UseSimpleText;
+bool URedTechArtToolsBlueprintLibrary::ExportTableToFile(const UDataTable* DataTable, const FString& Filename,
+                                                         const FRedDataTableExportOptions& Options,
+                                                         FRedDataTableExportStats& OutStats)
+{
+	return FRedDataTableExport::ExportToFile(DataTable, Filename, Options, OutStats);
+}
 
-		return DataTable->GetTableAsString(Flags);
-	}
-	return "";
+bool URedTechArtToolsBlueprintLibrary::ImportTableFromFile(UDataTable* DataTable, const FString& Filename,
+                                                           const FRedDataTableImportOptions& Options,
+                                                           FRedDataTableImportStats& OutStats)
+{
+	return FRedDataTableImport::ImportFromFile(DataTable, Filename, Options, OutStats);
+}
+
+TArray<FRedDataTableRowDiff> URedTechArtToolsBlueprintLibrary::DiffTables(const UDataTable* Old, const UDataTable* New)
+{
+	return FRedDataTableDiff::DiffTables(Old, New);
+}
+
+bool URedTechArtToolsBlueprintLibrary::DiffTableWithSnapshot(const UDataTable* DataTable,
+                                                             const FString& SnapshotFilename,
+                                                             const FRedDataTableExportOptions& ExportOptions,
+                                                             TArray<FRedDataTableRowDiff>& OutDiffs)
+{
+	return FRedDataTableDiff::DiffWithSnapshot(SnapshotFilename, DataTable, ExportOptions, OutDiffs);
+}
+
+bool URedTechArtToolsBlueprintLibrary::ExportTableDiffs(const TArray<FRedDataTableRowDiff>& Diffs,
+                                                        const FString& Filename)
+{
+	return FRedDataTableDiff::ExportDiffs(Diffs, Filename);
 }
 
 bool URedTechArtToolsBlueprintLibrary::AlphaNumericLessThan(const FString& A, const  FString& B)
@@ -28,7 +28,12 @@
 #include "ISettingsModule.h"
 #include "RedBPEnum.h"
 #include "RedDeveloperSettings.h"
+#include "RedEditorIconIndex.h"
 #include "RedEditorIconWidget.h"
+#include "RedMaterialExpressionIndex.h"
+#include "RedMaterialParameterBlueprintLibrary.h"
+#include "RedMaterialParameterIndex.h"
+#include "RedMaterialTextureMemory.h"
 #include "ToolMenus.h"
 #include "EditorUtilityToolMenu.h"
 #include "EditorUtilityWidget.h"
@@ -61,6 +66,10 @@ void FRedTechArtToolsEditor::StartupModule()
 		FOnGetPropertyTypeCustomizationInstance::CreateStatic(&FRedBPEnumCustomization::MakeInstance));
 	PropertyModule.NotifyCustomizationModuleChanged();
 
+	FRedMaterialParameterIndex::RegisterTagWriter();
+	FRedMaterialExpressionIndex::RegisterTagWriter();
+	FRedMaterialTextureMemory::RegisterTagWriter();
+
 	// In StartupModule
 	IMainFrameModule& MainFrameModule = IMainFrameModule::Get();
 	if (MainFrameModule.IsWindowInitialized())
@@ -85,6 +94,17 @@ void FRedTechArtToolsEditor::ShutdownModule()
 		PropertyModule.NotifyCustomizationModuleChanged();
 	}
 
+	FRedEditorIconIndex::Shutdown();
+	FRedMaterialParameterIndex::Shutdown();
+	FRedMaterialExpressionIndex::Shutdown();
+	FRedMaterialTextureMemory::Shutdown();
+
+	// Drop a preview a script never ended, its values are put back rather than committed during shutdown.
+	URedMaterialParameterBlueprintLibrary::EndMaterialParameterPreview(false);
+
+	// Close any batch a script opened and never ended, so its transaction isn't left open.
+	URedMaterialParameterBlueprintLibrary::EndAllMaterialEditBatches();
+
 	if (ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
 	{
 		SettingsModule->UnregisterSettings("Project", "Plugins", "RedTechArtTools");
@@ -0,0 +1,47 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "RedMaterialParameterAuditCommandlet.generated.h"
+
+/**
+ * Writes the parameter metadata of every material and material function under the given paths to a CSV or JSON file.
+ * Runs headless, so it can be used on build machines with -nullrhi.
+ *
+ * UnrealEditor-Cmd <Project> -run=RedMaterialParameterAudit -Output=<File.csv|File.json>
+ *     [-Paths=/Game/A+/Game/B] [-Shard=<Index> -NumShards=<Count>] [-BatchSize=64]
+ *
+ * Run one process per shard with the same NumShards to split the work, each writes its own output file.
+ */
+UCLASS()
+class URedMaterialParameterAuditCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	URedMaterialParameterAuditCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,55 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "RedMaterialToolsCommandlet.generated.h"
+
+/**
+ * Runs the material parameter operations of URedMaterialParameterBlueprintLibrary without an interactive editor, so
+ * large refactors can run headless with -nullrhi -unattended.
+ *
+ * UnrealEditor-Cmd <Project> -run=RedMaterialTools <Subcommand> [-Paths=/Game/A+/Game/B | -Packages=/Game/A/M_A+...]
+ *     [-BatchSize=64] [-DryRun]
+ *
+ *	list		Logs every parameter.					[-Type=Scalar] [-Group=<Group>]
+ *	export		Writes parameter metadata to a file.	-Output=<File.csv|File.json|File.jsonl>
+ *	rename		Renames a parameter and its overrides.	-Parameter=<Name> -NewName=<Name>
+ *	regroup		Moves parameters to another group.		-NewGroup=<Group> and -Group=<Group> and/or -Parameter=<Name>
+ *	prune		Removes redundant instance overrides.
+ *	audit		Checks parameters for conflicting types, groups and ranges.	[-Output=<File.json>]
+ *
+ * Changed packages are saved once per batch, nothing is changed or saved with -DryRun. Returns 1 for bad arguments,
+ * assets that fail validation or to save, and audit conflicts.
+ */
+UCLASS()
+class URedMaterialToolsCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	URedMaterialToolsCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
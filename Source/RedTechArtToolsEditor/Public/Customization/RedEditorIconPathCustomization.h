@@ -23,6 +23,8 @@
 #pragma once
 #include "IPropertyTypeCustomization.h"
 
+class SSearchableComboBox;
+
 class FRedEditorIconPathCustomization : public IPropertyTypeCustomization
 {
 public:
@@ -39,12 +41,8 @@ public:
 
 private:
 	TSharedRef<SWidget> HandleGenerateWidget(TSharedPtr<FString> InItem);
+	TSharedRef<SWidget> HandleGenerateStyleWidget(TSharedPtr<FString> InItem);
 
-	TArray<TSharedPtr<FString>>* GetIconOptionsPointer();
-	TArray<TSharedPtr<FString>> CachedIconOptions;
-
-	static TArray<FString> GetIconOptionsFromPath();
-	static void GetIconsFromPath(const FString& InPath, TArray<FString>& OutFoundIcons);
-
-	TMap<FString, TUniquePtr<FSlateBrush>> GeneratedBrushes;
+	TSharedPtr<SSearchableComboBox> CachedSearchableComboBox;
+	TSharedPtr<SSearchableComboBox> CachedStyleComboBox;
 };
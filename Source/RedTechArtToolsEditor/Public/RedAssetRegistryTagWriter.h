@@ -0,0 +1,44 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Adds a hidden asset registry tag to assets when they are saved, so the material indices can be read from the asset
+ * registry without loading anything. Hides which of the engine's extra object tag delegates is available.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedAssetRegistryTagWriter
+{
+public:
+	/**
+	 * Starts writing TagName, set to MakeValue's result, on every object that passes ShouldWrite. Class default and
+	 * transient objects are always skipped.
+	 * @return Handle to pass to Unregister.
+	 */
+	static FDelegateHandle Register(FName TagName, TFunction<bool(const UObject*)> ShouldWrite,
+	                                TFunction<FString(const UObject*)> MakeValue);
+
+	/** Stops a writer added with Register and resets the handle. */
+	static void Unregister(FDelegateHandle& Handle);
+};
@@ -0,0 +1,81 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RedDataTableExport.h"
+#include "RedDataTableDiff.generated.h"
+
+class UDataTable;
+
+UENUM(BlueprintType)
+enum class ERedDataTableRowChange : uint8
+{
+	Added,
+	Removed,
+	Changed
+};
+
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedDataTableRowDiff
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableDiff)
+	FName RowName = NAME_None;
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableDiff)
+	ERedDataTableRowChange Change = ERedDataTableRowChange::Changed;
+
+	/** Columns with a different value, by display name. Only set for changed rows. */
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableDiff)
+	TArray<FName> ChangedColumns;
+};
+
+/**
+ * Row level differences between two DataTables, or between a table and a snapshot written by
+ * FRedDataTableExport. Each cell is hashed from its exported text in parallel, rows with the same hashes are
+ * unchanged, and only the cells of differing rows are compared. Columns are matched by name, so tables with
+ * different row structs can be compared.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedDataTableDiff
+{
+public:
+	/**
+	 * Rows added, changed or removed going from Old to New. Added and changed rows come first in New's row order,
+	 * then removed rows in Old's order.
+	 */
+	static TArray<FRedDataTableRowDiff> DiffTables(const UDataTable* Old, const UDataTable* New);
+
+	/**
+	 * Same as DiffTables with a CSV or JSON snapshot from an earlier revision as the old table. Returns false if the
+	 * snapshot couldn't be read.
+	 * @param ExportOptions The options the snapshot was exported with, the table's cells are formatted the same way.
+	 */
+	static bool DiffWithSnapshot(const FString& SnapshotFilename, const UDataTable* DataTable,
+	                             const FRedDataTableExportOptions& ExportOptions,
+	                             TArray<FRedDataTableRowDiff>& OutDiffs);
+
+	/** Writes diffs to a CSV or JSON file by its extension. Returns false if the file couldn't be written. */
+	static bool ExportDiffs(TConstArrayView<FRedDataTableRowDiff> Diffs, const FString& Filename);
+};
@@ -0,0 +1,118 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RedDataTableExport.generated.h"
+
+class FJsonValue;
+class UDataTable;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogRedDataTable, Log, All);
+
+enum class ERedDataTableFormat : uint8
+{
+	/** The engine's DataTable CSV layout, a "---" header cell above the row names. */
+	Csv,
+	/** An array of row objects with the row name in "Name", the layout the engine's JSON import reads. */
+	Json
+};
+
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedDataTableExportOptions
+{
+	GENERATED_BODY()
+
+	/** Index of the first exported row, in table order. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=DataTableExport, meta=(ClampMin=0))
+	int32 FirstRow = 0;
+
+	/** Number of rows to export from FirstRow, negative for all of them. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=DataTableExport)
+	int32 NumRows = -1;
+
+	/** Columns to export, by property name or display name. All columns if empty, the row name is always exported. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=DataTableExport)
+	TArray<FName> Columns;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=DataTableExport)
+	bool bUseJsonObjectsForStructs = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=DataTableExport)
+	bool bUseSimpleText = false;
+
+	/** Rows formatted before they are written out. Memory use depends on this, not on the size of the table. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=DataTableExport, meta=(ClampMin=1))
+	int32 RowsPerChunk = 1024;
+};
+
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedDataTableExportStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableExport)
+	int32 NumRows = 0;
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableExport)
+	int32 NumColumns = 0;
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableExport)
+	int64 NumBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableExport)
+	double Seconds = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableExport)
+	double MegabytesPerSecond = 0.0;
+};
+
+/**
+ * Writes DataTable rows straight to a file, a chunk of rows at a time, instead of building the whole table as one
+ * string like UDataTable::GetTableAsString. Rows are formatted in parallel and written in table order.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedDataTableExport
+{
+public:
+	/** Format matching the file extension, .json for JSON and CSV for anything else. */
+	static ERedDataTableFormat GetFormatFromFilename(const FString& Filename);
+
+	/** Returns false if the file couldn't be written. Must be called on the game thread. */
+	static bool ExportToFile(const UDataTable* DataTable, const FString& Filename,
+	                         const FRedDataTableExportOptions& Options, FRedDataTableExportStats& OutStats);
+
+	/** The same text ExportToFile writes, for tables small enough to hold in one string. RowsPerChunk is ignored. */
+	static FString ExportToString(const UDataTable* DataTable, ERedDataTableFormat Format,
+	                              const FRedDataTableExportOptions& Options);
+
+	/** One cell as written to CSV, before escaping. Only reads the row, so it can be called from any thread. */
+	static FString FormatCsvCell(const FProperty* Property, const uint8* RowData,
+	                             const FRedDataTableExportOptions& Options);
+
+	/** Quotes a CSV field if it contains a separator, quote or line break, doubling any quotes inside it. */
+	static FString EscapeCsvField(const FString& Field);
+
+	/** One cell as written to JSON. Only reads the row, so it can be called from any thread. */
+	static TSharedPtr<FJsonValue> FormatJsonCell(const FProperty* Property, const uint8* RowData,
+	                                             const FRedDataTableExportOptions& Options);
+};
@@ -0,0 +1,156 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RedDataTableExport.h"
+#include "RedDataTableImport.generated.h"
+
+class FJsonValue;
+class UDataTable;
+
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedDataTableImportOptions
+{
+	GENERATED_BODY()
+
+	/**
+	 * Remove rows of the table that aren't in the file. Only rows in the range ExportOptions exported are removed,
+	 * and nothing is if any row of the file failed to import.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=DataTableImport)
+	bool bRemoveMissingRows = false;
+
+	/** Only count the rows that would change, without touching the table. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=DataTableImport)
+	bool bDryRun = false;
+
+	/** The options the file was exported with, the table's cells are formatted the same way to compare them. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=DataTableImport)
+	FRedDataTableExportOptions ExportOptions;
+};
+
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedDataTableImportStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableImport)
+	int32 NumAdded = 0;
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableImport)
+	int32 NumUpdated = 0;
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableImport)
+	int32 NumRemoved = 0;
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableImport)
+	int32 NumUnchanged = 0;
+
+	/** Rows that couldn't be parsed or had values that don't fit their column, they are left as they are. */
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableImport)
+	int32 NumFailed = 0;
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category=DataTableImport)
+	double Seconds = 0.0;
+};
+
+/**
+ * A DataTable file in the layouts FRedDataTableExport writes, read back as the text of each cell. Cells hash the same
+ * as the table cells they were exported from, so rows can be compared without importing them.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedDataTableFile
+{
+public:
+	struct FRow
+	{
+		FName Name = NAME_None;
+
+		/** Text of each cell by column. CSV rows may be short, the missing trailing cells are left out. */
+		TArray<FString> Cells;
+
+		/** JSON value of each cell by column, null where the row leaves the column out. Empty for CSV. */
+		TArray<TSharedPtr<FJsonValue>> Values;
+
+		/** HashCell of each entry in Cells. */
+		TArray<uint32> CellHashes;
+
+		/** False if the row couldn't be parsed. */
+		bool bValid = true;
+
+		bool HasCell(const int32 Column) const
+		{
+			return Values.Num() > 0 ? Values[Column].IsValid() : Column < Cells.Num();
+		}
+	};
+
+	ERedDataTableFormat Format = ERedDataTableFormat::Csv;
+
+	/** Column names in file order, without the row name. */
+	TArray<FString> ColumnNames;
+
+	TArray<FRow> Rows;
+
+	/**
+	 * Reads a file by its extension, .json for JSON and CSV for anything else. Rows are parsed and hashed in parallel.
+	 * Returns false if the file couldn't be read, malformed rows are kept but marked invalid.
+	 */
+	bool Read(const FString& Filename);
+
+	/** The row struct property for each column, matched by name or display name, null if the struct has none. */
+	TArray<const FProperty*> FindColumnProperties(const UScriptStruct* RowStruct) const;
+
+	/**
+	 * Reads a cell into its property in RowData. Returns an error message, empty on success. Must be called on the
+	 * game thread, object references may be loaded.
+	 */
+	FString ImportCell(const FRow& Row, int32 Column, const FProperty* Property, uint8* RowData) const;
+
+	static uint32 HashCell(FStringView Text);
+
+	/** Hash of a table cell in the given format, the same as the hash of the cell it exports to. Thread safe. */
+	static uint32 HashCell(const FProperty* Property, const uint8* RowData, ERedDataTableFormat Format,
+	                       const FRedDataTableExportOptions& Options);
+
+	/** Text of a JSON cell, strings as they are and anything else as condensed JSON. */
+	static FString GetCellText(const TSharedPtr<FJsonValue>& Value);
+
+private:
+	bool ParseCsv(const FString& Text);
+	bool ParseJson(const FString& Text);
+};
+
+/**
+ * Imports a CSV or JSON file into an existing DataTable by only applying the rows that differ, instead of replacing
+ * every row like a reimport. Unchanged rows are found by comparing cell hashes in parallel.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedDataTableImport
+{
+public:
+	/**
+	 * Adds, updates and removes the rows that differ from the file in one transaction, with a single change
+	 * notification. Columns the file doesn't have are left as they are. Returns false if the file couldn't be read.
+	 */
+	static bool ImportFromFile(UDataTable* DataTable, const FString& Filename,
+	                           const FRedDataTableImportOptions& Options, FRedDataTableImportStats& OutStats);
+};
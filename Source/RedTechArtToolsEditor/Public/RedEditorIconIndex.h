@@ -0,0 +1,156 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFileChangeData;
+struct FSlateBrush;
+
+/** Image formats the editor icon widget can turn into a brush. */
+enum class ERedEditorIconFileType : uint8
+{
+	Unsupported,
+	Png,
+	Svg
+};
+
+/**
+ * Everything needed to draw a single row of the editor icon picker.
+ * Computed once when the icon index is built, so generating rows never touches the disk or re-derives labels.
+ */
+struct REDTECHARTTOOLSEDITOR_API FRedEditorIconEntry
+{
+	FRedEditorIconEntry(const FString& InPath, bool bInExists);
+
+	/** Path as stored in FRedEditorIconPath. This is the same string the picker's options list points at. */
+	TSharedRef<FString> Path;
+
+	FString AbsolutePath;
+	FText DisplayName;
+	FText Category;
+	ERedEditorIconFileType FileType = ERedEditorIconFileType::Unsupported;
+	bool bExists = false;
+
+	/** Bumped every time the file is modified on disk, so anything holding a brush for it knows to rebuild. */
+	uint32 Revision = 0;
+};
+
+/** A brush registered in one of the Slate style sets, listed by the picker's Slate Style mode. */
+struct REDTECHARTTOOLSEDITOR_API FRedEditorStyleIconEntry
+{
+	FRedEditorStyleIconEntry(FName InStyleSetName, FName InStyleName);
+
+	/** "StyleSetName::StyleName", the string the picker's options list points at. */
+	TSharedRef<FString> Key;
+
+	FName StyleSetName;
+	FName StyleName;
+	FText DisplayName;
+	FText Category;
+};
+
+DECLARE_MULTICAST_DELEGATE(FOnRedEditorIconIndexChanged);
+
+/**
+ * Index of all the editor icons found in the URedDeveloperSettings::EditorIconWidgetSearchPaths.
+ * Shared between every icon path customization so the search paths are only scanned once per editor session.
+ * Each search path is watched with the DirectoryWatcher, so icons that are added, removed or renamed on disk are
+ * patched into the index without rescanning.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedEditorIconIndex
+{
+public:
+	static FRedEditorIconIndex& Get();
+
+	/** Stops watching the search paths and releases all entries and brushes. Called on module shutdown. */
+	static void Shutdown();
+
+	~FRedEditorIconIndex();
+
+	/** Options list for an SSearchableComboBox, each option is the Path of an entry. */
+	TArray<TSharedPtr<FString>>* GetOptionsSource();
+
+	/** Finds the entry for an icon path, or nullptr if the path is not in any of the search paths. */
+	TSharedPtr<const FRedEditorIconEntry> FindEntry(const FString& InPath);
+
+	/**
+	 * Does the icon exist on disk. Indexed icons are answered from the index, anything else is checked on disk and
+	 * remembered once it is found.
+	 */
+	bool DoesIconExist(const FString& InPath);
+
+	/**
+	 * Gets the brush used to preview an icon in the picker, creating it on first use.
+	 * Returned as a shared pointer so rows can keep it alive if the icon is invalidated while they are visible.
+	 */
+	TSharedPtr<FSlateBrush> GetPreviewBrush(const FRedEditorIconEntry& Entry);
+
+	/**
+	 * Options list of every image brush in the registered Slate style sets, each option is the Key of a style entry.
+	 * Rebuilt when style sets have been registered or unregistered since the last call.
+	 */
+	TArray<TSharedPtr<FString>>* GetStyleOptionsSource();
+
+	/** Finds the style entry for an option from GetStyleOptionsSource. */
+	TSharedPtr<const FRedEditorStyleIconEntry> FindStyleEntry(const FString& InKey) const;
+
+	/** Broadcast after the index has been patched by a directory change. */
+	FOnRedEditorIconIndexChanged& OnIndexChanged() { return IndexChangedEvent; }
+
+private:
+	struct FWatchedDirectory
+	{
+		/** Entry from EditorIconWidgetSearchPaths, relative to the engine directory. */
+		FString SearchPath;
+		/** Search directory as FindFilesRecursive sees it, the prefix of every entry Path. */
+		FString Directory;
+		/** Absolute form of Directory, the prefix of every path the DirectoryWatcher reports. */
+		FString AbsoluteDirectory;
+		FDelegateHandle Handle;
+	};
+
+	void BuildIndex();
+	void BuildStyleIndex();
+	void AddEntry(const FString& InPath);
+	void RemoveEntry(const FString& InPath);
+
+	void WatchDirectories();
+	void UnwatchDirectories();
+	void HandleDirectoryChanged(const TArray<FFileChangeData>& FileChanges, int32 WatchedDirectoryIndex);
+
+	static void GetIconsFromPath(const FString& InPath, TArray<FString>& OutFoundIcons);
+
+	bool bIsBuilt = false;
+	TArray<TSharedPtr<FString>> Options;
+	TMap<FString, TSharedRef<FRedEditorIconEntry>> Entries;
+	TMap<FString, TSharedPtr<FSlateBrush>> PreviewBrushes;
+	/** Unindexed icon paths that were found on disk. */
+	TSet<FString> UnindexedIcons;
+	TArray<FWatchedDirectory> WatchedDirectories;
+
+	TArray<TSharedPtr<FString>> StyleOptions;
+	TMap<FString, TSharedRef<FRedEditorStyleIconEntry>> StyleEntries;
+	TSet<FName> IndexedStyleSets;
+	FOnRedEditorIconIndexChanged IndexChangedEvent;
+};
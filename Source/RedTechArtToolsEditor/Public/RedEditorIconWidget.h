@@ -29,14 +29,38 @@
 #include "RedEditorIconWidget.generated.h"
 
 class UImage;
+struct FRedEditorIconEntry;
+
+UENUM()
+enum class ERedEditorIconSource : uint8
+{
+	/** Load a .png or .svg from the engine content directories. */
+	File,
+	/** Use a brush that is already registered in a Slate style set, like FAppStyle. */
+	SlateStyle
+};
 
 USTRUCT()
 struct FRedEditorIconPath
 {
 	GENERATED_BODY()
 
+	UPROPERTY(EditAnywhere, Category="Editor Icon Path")
+	ERedEditorIconSource Source = ERedEditorIconSource::File;
+
 	UPROPERTY(EditAnywhere, Category="Editor Icon Path")
 	FString Path;
+
+	/** Name of the registered Slate style set, used when Source is SlateStyle. */
+	UPROPERTY(EditAnywhere, Category="Editor Icon Path")
+	FName StyleSetName;
+
+	/** Name of the brush inside StyleSetName, used when Source is SlateStyle. */
+	UPROPERTY(EditAnywhere, Category="Editor Icon Path")
+	FName StyleName;
+
+	/** Finds the registered brush for a SlateStyle icon, or nullptr if the style set or brush isn't registered. */
+	const FSlateBrush* FindStyleBrush() const;
 };
 
 
@@ -60,5 +84,26 @@ protected:
 	virtual void SynchronizeProperties() override;
 
 private:
+	/** Everything IconBrush was last built from. SynchronizeProperties only rebuilds the brush when this changes. */
+	struct FIconBrushKey
+	{
+		FString Path;
+		FVector2D Size = FVector2D::ZeroVector;
+		FSlateColor TintColor;
+		TEnumAsByte<ESlateBrushTileType::Type> Tiling = ESlateBrushTileType::NoTile;
+		TWeakPtr<const FRedEditorIconEntry> Entry;
+		uint32 Revision = 0;
+
+		bool operator==(const FIconBrushKey& Other) const
+		{
+			return Path == Other.Path && Size == Other.Size && TintColor == Other.TintColor
+				&& Tiling == Other.Tiling && Entry == Other.Entry && Revision == Other.Revision;
+		}
+	};
+
 	TUniquePtr<FSlateBrush> IconBrush;
+	FIconBrushKey IconBrushKey;
+
+	/** True while the image is drawing a brush owned by a Slate style set instead of IconBrush. */
+	bool bBoundToStyleBrush = false;
 };
@@ -0,0 +1,42 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Writes a USTRUCT to a UTF-8 JSON file, the way the material reports and presets are saved, logging when the file
+ * can't be written.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedJsonStructFile
+{
+public:
+	/** @return False if the struct couldn't be converted or the file couldn't be written. */
+	template <typename StructType>
+	static bool Save(const StructType& Struct, const FString& Filename)
+	{
+		return Save(StructType::StaticStruct(), &Struct, Filename);
+	}
+
+	static bool Save(const UStruct* StructDefinition, const void* Struct, const FString& Filename);
+};
@@ -0,0 +1,90 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ScopedTransaction.h"
+
+class UMaterial;
+class UMaterialExpression;
+class UMaterialFunctionInterface;
+
+/**
+ * Groups material expression edits together.
+ * While a batch is active every expression is only Modify()'d once, all of the edits share a single undo transaction,
+ * and each affected material or material function is only updated and recompiled once, when the batch ends.
+ *
+ * Use it on the stack around a group of edits:
+ *	FRedMaterialEditBatch Batch(LOCTEXT("RenameParameters", "Rename Parameters"));
+ *	FRedMaterialEditBatch::ModifyExpression(Expression);
+ *	Expression->Desc = ...;
+ *
+ * Batches nest. An inner batch hands everything it recorded to the outer one, so only the outermost batch updates
+ * materials. Edits to a material function recompile every loaded material that uses it, and a material is only
+ * recompiled once even if it was edited directly and uses several edited functions.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedMaterialEditBatch
+{
+public:
+	explicit FRedMaterialEditBatch(const FText& Description);
+	~FRedMaterialEditBatch();
+
+	FRedMaterialEditBatch(const FRedMaterialEditBatch&) = delete;
+	FRedMaterialEditBatch& operator=(const FRedMaterialEditBatch&) = delete;
+
+	/** The batch that edits are currently being recorded into, or nullptr if there isn't one. */
+	static FRedMaterialEditBatch* GetActive();
+
+	/**
+	 * Call before changing an expression.
+	 * Inside a batch the expression and its owning material or function are only modified the first time and the
+	 * owner is updated when the batch ends. Outside a batch this is just Expression->Modify(). While a
+	 * FRedMaterialParameterPreview is active the expression is recorded by the preview instead.
+	 */
+	static void ModifyExpression(UMaterialExpression* Expression);
+
+	/** Number of distinct expressions modified in this batch so far. */
+	int32 GetNumModifiedExpressions() const { return ModifiedExpressions.Num(); }
+
+	/**
+	 * Ends the batch early, updating and recompiling everything that was edited. Called by the destructor if it
+	 * hasn't been already. Nested batches hand their edits to the outer batch instead and return 0.
+	 * @param bWaitForCompilation Block until the shader compiles that were kicked off have finished.
+	 * @return The number of materials that were recompiled.
+	 */
+	int32 Finish(bool bWaitForCompilation = false);
+
+private:
+	void RecordExpression(UMaterialExpression* Expression);
+	void MergeInto(FRedMaterialEditBatch& Outer);
+	int32 UpdateDirtyObjects(bool bWaitForCompilation);
+
+	FScopedTransaction Transaction;
+
+	TSet<TWeakObjectPtr<UMaterialExpression>> ModifiedExpressions;
+	TSet<TWeakObjectPtr<UMaterial>> DirtyMaterials;
+	TSet<TWeakObjectPtr<UMaterialFunctionInterface>> DirtyFunctions;
+
+	FRedMaterialEditBatch* PreviousActive = nullptr;
+	bool bFinished = false;
+};
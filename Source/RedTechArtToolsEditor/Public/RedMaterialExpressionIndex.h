@@ -0,0 +1,139 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "RedMaterialExpressionIndex.generated.h"
+
+class UMaterialExpression;
+
+/** One expression in a material or material function, as recorded in its asset registry tags. */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedIndexedMaterialExpression
+{
+	GENERATED_BODY()
+
+	/** The material or material function the expression is in. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialExpressionIndex)
+	FSoftObjectPath Asset;
+
+	/** Expression class name without the MaterialExpression prefix, e.g. TextureSample or Custom. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialExpressionIndex)
+	FName ExpressionClass = NAME_None;
+
+	/** Object name of the expression inside the asset. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialExpressionIndex)
+	FName ExpressionName = NAME_None;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialExpressionIndex)
+	FGuid ExpressionGuid;
+
+	/** The node's description, or the text of a comment. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialExpressionIndex)
+	FString Description;
+
+	/** Parameter name for parameter and collection parameter expressions. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialExpressionIndex)
+	FName ParameterName = NAME_None;
+
+	/** Texture, material function or parameter collection the expression uses, if any. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialExpressionIndex)
+	FSoftObjectPath ReferencedAsset;
+
+	/** Texture, Function or Collection, or None if there is no referenced asset. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialExpressionIndex)
+	FName ReferenceType = NAME_None;
+};
+
+/**
+ * Project wide index of the expressions in every material and material function, searchable without loading them.
+ *
+ * Works like FRedMaterialParameterIndex: expressions are written into a hidden asset registry tag when an asset is
+ * saved, and the index is rebuilt from those tags and kept up to date from asset registry events.
+ *
+ * Queries are whitespace separated terms that all have to match. Values are case insensitive and accept * and ?
+ * wildcards, quote values that contain spaces and prefix a term with - to exclude matches.
+ *	class:TextureSample		Expression class, with or without the MaterialExpression prefix.
+ *	name:BaseColor*			Parameter name.
+ *	desc:"needs cleanup"	Node description or comment text.
+ *	texture:T_Rock_*		Referenced texture, by asset name or full path. function: and collection: work the same,
+ *							ref: matches any referenced asset.
+ *	asset:/Game/Materials/*	The material or function the expression is in.
+ *	Custom					A term without a key matches the class, parameter name or description.
+ * desc: and terms without a key match anywhere in the text, the others have to match the whole value.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedMaterialExpressionIndex
+{
+public:
+	static const FName ExpressionsTagName;
+
+	static FRedMaterialExpressionIndex& Get();
+
+	/** Starts writing the expression tag for saved materials. Called on module startup. */
+	static void RegisterTagWriter();
+
+	/** Stops writing tags and releases the index. Called on module shutdown. */
+	static void Shutdown();
+
+	~FRedMaterialExpressionIndex();
+
+	/** Every indexed expression matching the query, see the class comment for the syntax. */
+	TArray<FRedIndexedMaterialExpression> Find(const FString& Query);
+
+	/**
+	 * Gets the indexed expressions of a single material or material function without loading it.
+	 * @return False if the asset isn't indexed.
+	 */
+	bool GetAssetExpressions(const FSoftObjectPath& Asset, TArray<FRedIndexedMaterialExpression>& OutExpressions);
+
+	/** Materials and functions without an expression tag yet, they need to be resaved to be searchable. */
+	TArray<FSoftObjectPath> GetUnindexedAssets();
+
+	/** Loads the expression's asset if needed and finds the expression in it, or returns null if it is gone. */
+	static UMaterialExpression* ResolveExpression(const FRedIndexedMaterialExpression& Expression);
+
+	static FString MakeExpressionsTagValue(const UObject* MaterialOrFunction);
+
+	static void ParseExpressionsTagValue(const FSoftObjectPath& Asset, FStringView TagValue,
+	                                     TArray<FRedIndexedMaterialExpression>& OutExpressions);
+
+private:
+	void BuildIndex();
+	void AddAsset(const FAssetData& AssetData);
+
+	void HandleAssetAddedOrUpdated(const FAssetData& AssetData);
+	void HandleAssetRemoved(const FAssetData& AssetData);
+	void HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+	void HandleFilesLoaded();
+
+	bool bIsBuilt = false;
+	TMap<FSoftObjectPath, TArray<FRedIndexedMaterialExpression>> ExpressionsByAsset;
+	TSet<FSoftObjectPath> UnindexedAssets;
+
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetUpdatedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle FilesLoadedHandle;
+};
@@ -0,0 +1,120 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RedMaterialInstanceHierarchy.generated.h"
+
+class UMaterialFunctionInterface;
+class UMaterialInstanceConstant;
+class UPackage;
+
+/** What pruning redundant material instance overrides removed, or would remove in a dry run. */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedMaterialOverridePruneReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialInstances)
+	int32 NumInstancesVisited = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialInstances)
+	int32 NumInstancesChanged = 0;
+
+	/** Scalar, vector, texture, font and virtual texture overrides that matched the inherited value. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialInstances)
+	int32 NumOverridesRemoved = 0;
+
+	/** Static switch and component mask overrides that matched the inherited value. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialInstances)
+	int32 NumStaticOverridesRemoved = 0;
+
+	/** Instances that no longer need their own static permutation, each one is a set of shader maps less to compile. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialInstances)
+	int32 NumShaderPermutationsRemoved = 0;
+
+	/** How much smaller the saved packages got on disk. Only measured when packages are saved. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialInstances)
+	int64 PackageBytesSaved = 0;
+
+	/** Changed instances that couldn't be saved, they are left loaded and dirty. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialInstances)
+	int32 NumFailedSaves = 0;
+
+	/** Instances that had redundant overrides. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialInstances)
+	TArray<FSoftObjectPath> ChangedInstances;
+};
+
+/**
+ * Finds and loads the material instances that inherit from a material or material function, using the asset
+ * registry so unrelated assets are never loaded.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedMaterialInstanceHierarchy
+{
+public:
+	/**
+	 * Saved materials that use the function, directly or through other functions, and the material instance constants
+	 * that reference it or one of those functions themselves, usually through their own layer stack.
+	 */
+	static void FindAssetsUsingFunction(const FSoftObjectPath& MaterialFunction, TArray<FSoftObjectPath>& OutMaterials,
+	                                    TArray<FSoftObjectPath>& OutInstances);
+
+	/**
+	 * Every material instance constant below the given materials or instances, read from the Parent asset registry
+	 * tag. Parents always come before their children.
+	 */
+	static TArray<FSoftObjectPath> FindDescendantInstances(TConstArrayView<FSoftObjectPath> Parents);
+
+	/**
+	 * Async loads the assets BatchSize at a time and calls Visitor with each loaded batch. Assets that fail to load
+	 * are logged and left out. If bCollectGarbage is set, garbage is collected after each batch so memory stays
+	 * bounded, Visitor must not hold on to the objects.
+	 */
+	static void LoadInBatches(TConstArrayView<FSoftObjectPath> Assets, int32 BatchSize, bool bCollectGarbage,
+	                          TFunctionRef<void(TConstArrayView<UObject*>)> Visitor);
+
+	/**
+	 * Saves the dirty packages, logging each one that failed to save.
+	 * @return The number of packages that failed to save.
+	 */
+	static int32 SavePackages(const TArray<UPackage*>& Packages);
+
+	/**
+	 * Renames the instance's overrides of a parameter, including static switch and component mask overrides.
+	 * @param OwningFunction The function the parameter is in, or null for a material parameter. Layer and blend
+	 *                       overrides are only renamed where the instance's layer or blend at their index is, or uses,
+	 *                       this function.
+	 * @return True if any override was renamed.
+	 */
+	static bool RenameParameterOverrides(UMaterialInstanceConstant* Instance, FName OldName, FName NewName,
+	                                     const UMaterialFunctionInterface* OwningFunction);
+
+	/**
+	 * Removes overrides, including static ones, whose value is the same as the one the instance would inherit from
+	 * its parent, and adds what was removed to Report. With bDryRun the instance isn't changed, only counted.
+	 * @return True if the instance had any redundant overrides.
+	 */
+	static bool PruneRedundantOverrides(UMaterialInstanceConstant* Instance, bool bDryRun,
+	                                    FRedMaterialOverridePruneReport& Report);
+};
@@ -0,0 +1,165 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogRedMaterialParameterAudit, Log, All);
+
+/** One parameter's metadata, as written by the material parameter audit. */
+struct REDTECHARTTOOLSEDITOR_API FRedMaterialParameterAuditRow
+{
+	/** Object path of the material or material function the parameter lives in. */
+	FString Asset;
+	FName AssetClass = NAME_None;
+	FName ParameterName = NAME_None;
+	/** Same names as URedMaterialParameterBlueprintLibrary::GetMaterialParameter_TypeName, or CollectionParameter. */
+	FName TypeName = NAME_None;
+	FName Group = NAME_None;
+	int32 SortPriority = 0;
+	FString Description;
+	float ScalarMin = 0.0f;
+	float ScalarMax = 0.0f;
+	FGuid ExpressionGuid;
+};
+
+/** The columns of an audit row, used to tell which fields an imported row actually contained. */
+enum class ERedMaterialParameterAuditColumns : uint16
+{
+	None = 0,
+	Asset = 1 << 0,
+	AssetClass = 1 << 1,
+	ParameterName = 1 << 2,
+	Type = 1 << 3,
+	Group = 1 << 4,
+	SortPriority = 1 << 5,
+	Description = 1 << 6,
+	ScalarMin = 1 << 7,
+	ScalarMax = 1 << 8,
+	ExpressionGuid = 1 << 9,
+};
+ENUM_CLASS_FLAGS(ERedMaterialParameterAuditColumns);
+
+enum class ERedMaterialParameterAuditFormat : uint8
+{
+	Csv,
+	/** A single JSON array, with one row object per line. */
+	Json,
+	/** One JSON row object per line, without the enclosing array. */
+	JsonLines
+};
+
+/**
+ * Streams audit rows to a CSV or JSON file as they are produced, so memory use doesn't grow with the number of
+ * audited assets. Rows are formatted in parallel and written in the order they were given.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedMaterialParameterAuditWriter
+{
+public:
+	/** Opens Filename for writing, returns null if the file can't be created. */
+	static TUniquePtr<FRedMaterialParameterAuditWriter> Create(const FString& Filename,
+	                                                           ERedMaterialParameterAuditFormat Format);
+
+	/** Format matching the file extension, .json for JSON, .jsonl for JSON Lines and CSV for anything else. */
+	static ERedMaterialParameterAuditFormat GetFormatFromFilename(const FString& Filename);
+
+	~FRedMaterialParameterAuditWriter();
+
+	void Write(TConstArrayView<FRedMaterialParameterAuditRow> Rows);
+
+	/** Finishes the file. Called by the destructor if it wasn't called already. */
+	void Close();
+
+	int32 GetNumWrittenRows() const { return NumWrittenRows; }
+
+private:
+	FRedMaterialParameterAuditWriter(TUniquePtr<FArchive>&& InArchive, ERedMaterialParameterAuditFormat InFormat);
+
+	void WriteString(const FString& String);
+
+	TUniquePtr<FArchive> Archive;
+	ERedMaterialParameterAuditFormat Format;
+	int32 NumWrittenRows = 0;
+};
+
+/**
+ * Reads rows back from a file written by FRedMaterialParameterAuditWriter, or edited by hand or in a spreadsheet,
+ * one line at a time without loading the whole file. CSV columns are matched by the header so they can be
+ * reordered or left out, JSON rows may leave out any field.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedMaterialParameterAuditReader
+{
+public:
+	/**
+	 * Calls Visitor with every row in the file and the columns that row had values for.
+	 * Returns false if the file couldn't be read, malformed rows are logged and skipped.
+	 */
+	static bool ReadFile(const FString& Filename,
+	                     TFunctionRef<void(const FRedMaterialParameterAuditRow&, ERedMaterialParameterAuditColumns)>
+	                     Visitor);
+};
+
+struct REDTECHARTTOOLSEDITOR_API FRedMaterialParameterAuditOptions
+{
+	/** Content paths to audit recursively. Defaults to /Game if empty. */
+	TArray<FName> PackagePaths;
+
+	/**
+	 * Splits the audited packages into NumShards stable groups and only audits group Shard, so the audit can be
+	 * spread across several processes. The split only depends on package names.
+	 */
+	int32 Shard = 0;
+	int32 NumShards = 1;
+
+	/** Number of packages async loaded together before their parameters are gathered. */
+	int32 BatchSize = 64;
+
+	/** Packages loaded before memory is reclaimed with a garbage collection. */
+	int32 PackagesPerGarbageCollection = 512;
+};
+
+/**
+ * Gathers parameter metadata from many materials and material functions at once, for naming and consistency audits
+ * run from a commandlet or a script. Doesn't need an editor or a rendering device.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedMaterialParameterAudit
+{
+public:
+	/** Materials and material functions in the option's paths and shard, sorted by package name. */
+	static TArray<FAssetData> FindAssets(const FRedMaterialParameterAuditOptions& Options);
+
+	/** Whether the package belongs to Shard when split into NumShards. */
+	static bool IsPackageInShard(FName PackageName, int32 Shard, int32 NumShards);
+
+	/**
+	 * Appends a row for every parameter directly in each material or function, parameters in functions they use
+	 * are audited with the function. Must be called on the game thread.
+	 */
+	static void GatherRows(TConstArrayView<UObject*> MaterialsOrFunctions, TArray<FRedMaterialParameterAuditRow>& OutRows);
+
+	/**
+	 * Loads the assets in batches and writes their rows to Writer. Returns the number of assets that failed to load.
+	 */
+	static int32 Run(const FRedMaterialParameterAuditOptions& Options, FRedMaterialParameterAuditWriter& Writer);
+};
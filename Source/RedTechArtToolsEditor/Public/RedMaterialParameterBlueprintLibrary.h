@@ -26,52 +26,23 @@
 #include "BlueprintEditorLibrary.h"
 #include "MaterialTypes.h"
 #include "Materials/MaterialExpression.h"
+#include "RedMaterialExpressionIndex.h"
+#include "RedMaterialInstanceHierarchy.h"
+#include "RedMaterialParameterCollectionUsage.h"
+#include "RedMaterialParameterConsistency.h"
+#include "RedMaterialParameterIndex.h"
+#include "RedMaterialParameterPreset.h"
+#include "RedMaterialPermutationAnalysis.h"
+#include "RedMaterialTextureMemory.h"
+#include "RedParameterChannelNamesWrapper.h"
 #include "RedMaterialParameterBlueprintLibrary.generated.h"
 
 class UCurveLinearColor;
 class UCurveLinearColorAtlas;
+class UTexture;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogRedTechArtToolsBlueprintEditorLib, Warning, All);
 
-USTRUCT(BlueprintType)
-struct FRedParameterChannelNamesWrapper
-{
-	GENERATED_USTRUCT_BODY()
-
-	FRedParameterChannelNamesWrapper() = default;
-
-	FRedParameterChannelNamesWrapper(const FText& InR, const FText& InG, const FText& InB,
-	                                 const FText& InA) : R(InR), G(InG), B(InB), A(InA)
-	{
-	}
-
-	FRedParameterChannelNamesWrapper(const FParameterChannelNames& ChannelNames)
-	{
-		R = ChannelNames.R;
-		G = ChannelNames.G;
-		B = ChannelNames.B;
-		A = ChannelNames.A;
-	}
-
-	FParameterChannelNames ToParameterChannelNames() const
-	{
-		return FParameterChannelNames(R, G, B, A);
-	}
-
-
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = MaterialExpressionVectorParameter)
-	FText R;
-
-	UPROPERTY(BlueprintReadWrite, Category = MaterialExpressionVectorParameter)
-	FText G;
-
-	UPROPERTY(BlueprintReadWrite, Category = MaterialExpressionVectorParameter)
-	FText B;
-
-	UPROPERTY(BlueprintReadWrite, Category = MaterialExpressionVectorParameter)
-	FText A;
-};
-
 USTRUCT(BlueprintType)
 struct REDTECHARTTOOLSEDITOR_API FRedMaterialParameterInfo
 {
@@ -102,6 +73,66 @@ struct REDTECHARTTOOLSEDITOR_API FRedMaterialParameterInfo
 	FMaterialParameterMetadata ParameterInfo;
 };
 
+/**
+ * A set of changes to a single material parameter, applied together with the other edits passed to
+ * ApplyMaterialParameterEdits. Only the fields whose bSet flag is enabled are written.
+ */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedMaterialParameterEdit
+{
+	GENERATED_BODY()
+
+	FRedMaterialParameterEdit() = default;
+
+	explicit FRedMaterialParameterEdit(const FRedMaterialParameterInfo& InInfo) : Info(InInfo)
+	{
+	}
+
+	/** The parameter to edit. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit)
+	FRedMaterialParameterInfo Info;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit, meta=(InlineEditConditionToggle))
+	bool bSetName = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit, meta=(EditCondition="bSetName"))
+	FName Name = NAME_None;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit, meta=(InlineEditConditionToggle))
+	bool bSetGroup = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit, meta=(EditCondition="bSetGroup"))
+	FName Group = NAME_None;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit, meta=(InlineEditConditionToggle))
+	bool bSetDescription = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit, meta=(EditCondition="bSetDescription"))
+	FString Description;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit, meta=(InlineEditConditionToggle))
+	bool bSetSortPriority = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit, meta=(EditCondition="bSetSortPriority"))
+	int32 SortPriority = 32;
+
+	/** Only applies to scalar parameters. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit, meta=(InlineEditConditionToggle))
+	bool bSetScalarMinMax = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit, meta=(EditCondition="bSetScalarMinMax"))
+	float ScalarMin = 0.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit, meta=(EditCondition="bSetScalarMinMax"))
+	float ScalarMax = 1.0f;
+
+	/** Only applies to vector and texture sample parameters. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit, meta=(InlineEditConditionToggle))
+	bool bSetChannelNames = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterEdit, meta=(EditCondition="bSetChannelNames"))
+	FRedParameterChannelNamesWrapper ChannelNames;
+};
 
 /**
  *	Blueprint Library for getting and setting information about Material Parameter Expressions.
@@ -135,6 +166,33 @@ public:
 	static TArray<UMaterialExpression*> GetAllMaterialParameterExpressionsInFunction(
 		UMaterialFunction* MaterialFunction, bool bExcludeContainedFunctions = false);
 
+	/**
+	 * Gets the MaterialParameterInfo for every parameter in the material and, unless bExcludeFunctions, in the material
+	 * functions it uses, in a single walk of the graph that visits each function once.
+	 * TypeNames and Groups are optional filters, leave them empty to get every parameter. Type names match
+	 * GetMaterialParameter_TypeName, with CollectionParameter for parameter collection nodes.
+	 */
+	UFUNCTION(BlueprintCallable, Category=MaterialExpressions, meta=(AutoCreateRefTerm="TypeNames,Groups"))
+	static TArray<FRedMaterialParameterInfo> GetAllMaterialParameterInfos(
+		UMaterialInterface* MaterialInterface, bool bExcludeFunctions, const TArray<FName>& TypeNames,
+		const TArray<FName>& Groups);
+
+	/** Same as GetAllMaterialParameterInfos, for a material function. */
+	UFUNCTION(BlueprintCallable, Category=MaterialExpressions, meta=(AutoCreateRefTerm="TypeNames,Groups"))
+	static TArray<FRedMaterialParameterInfo> GetAllMaterialParameterInfosInFunction(
+		UMaterialFunction* MaterialFunction, bool bExcludeContainedFunctions, const TArray<FName>& TypeNames,
+		const TArray<FName>& Groups);
+
+	/**
+	 * Calls Visitor for every parameter expression in a material or material function, and in the material functions
+	 * and layers it uses when bIncludeFunctions is set. Each function is only walked once however often it is used.
+	 */
+	static void ForEachMaterialParameterExpression(UObject* MaterialOrFunction, bool bIncludeFunctions,
+	                                               TFunctionRef<void(UMaterialExpression*)> Visitor);
+
+	/** Type name of a parameter expression, as GetMaterialParameter_TypeName, or CollectionParameter. */
+	static FName GetParameterExpressionTypeName(const UMaterialExpression* Expression);
+
 	/** Gets the MaterialParameterInfo struct, this stores all the current editable data on the parameter expression,
 	 * and provides an interface for changing these properties on the expression.
 	 */
@@ -224,4 +282,276 @@ public:
 	UFUNCTION(BlueprintCallable, Category=MaterialExpressions)
 	static void SetMaterialParameter_ScalarAtlas(UPARAM(ref) FRedMaterialParameterInfo& Info,
 	                                             UCurveLinearColorAtlas* ScalarAtlas);
+
+	/**
+	 * Applies many parameter edits at once. The whole batch is a single undo transaction, each expression and
+	 * owning material or function is only modified once, and every affected material or function is updated and
+	 * recompiled once at the end instead of after every change. Fields that already have the requested value are
+	 * skipped.
+	 * @return The number of parameter expressions that were changed.
+	 */
+	UFUNCTION(BlueprintCallable, Category=MaterialExpressions)
+	static int32 ApplyMaterialParameterEdits(UPARAM(ref) const TArray<FRedMaterialParameterEdit>& Edits);
+
+	/**
+	 * Starts recording every material parameter edit made through this library into one batch, until the matching
+	 * EndMaterialEditBatch. The batch is a single undo transaction and materials are not recompiled until it ends,
+	 * so setters can be called in a loop without the material pipeline reacting to each one. Batches can be nested.
+	 * From Python use the helpers.materials.material_edit_batch context manager so the batch always ends.
+	 */
+	UFUNCTION(BlueprintCallable, Category=MaterialExpressions)
+	static void BeginMaterialEditBatch(const FText& Description);
+
+	/**
+	 * Ends the batch started by the last BeginMaterialEditBatch. Each material that was edited, or uses an edited
+	 * material function, is recompiled exactly once.
+	 * @param bWaitForCompilation Block until the shaders for the recompiled materials have finished compiling.
+	 * @return The number of materials that were recompiled.
+	 */
+	UFUNCTION(BlueprintCallable, Category=MaterialExpressions)
+	static int32 EndMaterialEditBatch(bool bWaitForCompilation = false);
+
+	/** Is there a batch started with BeginMaterialEditBatch that hasn't been ended yet. */
+	UFUNCTION(BlueprintCallable, Category=MaterialExpressions)
+	static bool IsMaterialEditBatchActive();
+
+	/** Ends every batch a script started and never ended, innermost first. Used on shutdown. */
+	static void EndAllMaterialEditBatches();
+
+	/**
+	 * Starts a live preview for an interaction such as dragging a slider. Until EndMaterialParameterPreview, setters
+	 * write straight to the expressions without undo transactions or recompiles, and the latest scalar and vector
+	 * defaults are shown in the viewports once per frame however often they are set.
+	 * From Python use the helpers.materials.material_parameter_preview context manager so the preview always ends.
+	 */
+	UFUNCTION(BlueprintCallable, Category=MaterialExpressions)
+	static void BeginMaterialParameterPreview(const FText& Description);
+
+	/**
+	 * Ends the preview started by BeginMaterialParameterPreview.
+	 * @param bCommit Apply the final values as one undoable edit and recompile, otherwise restore the original values.
+	 * @return The number of parameters that were committed.
+	 */
+	UFUNCTION(BlueprintCallable, Category=MaterialExpressions)
+	static int32 EndMaterialParameterPreview(bool bCommit = true);
+
+	UFUNCTION(BlueprintCallable, Category=MaterialExpressions)
+	static bool IsMaterialParameterPreviewActive();
+
+	/**
+	 * Default values of many parameters at once, in the same order as Infos. Parameters that aren't scalars get 0.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Defaults")
+	static TArray<float> GetMaterialParameterScalarDefaults(const TArray<FRedMaterialParameterInfo>& Infos);
+
+	/** Default values of many parameters at once, in the same order as Infos. Non vector parameters get black. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Defaults")
+	static TArray<FLinearColor> GetMaterialParameterVectorDefaults(const TArray<FRedMaterialParameterInfo>& Infos);
+
+	/** Default values of many parameters at once, in the same order as Infos. Non texture parameters get null. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Defaults")
+	static TArray<UTexture*> GetMaterialParameterTextureDefaults(const TArray<FRedMaterialParameterInfo>& Infos);
+
+	/** Default values of many parameters at once, in the same order as Infos. Non static switches get false. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Defaults")
+	static TArray<bool> GetMaterialParameterStaticSwitchDefaults(const TArray<FRedMaterialParameterInfo>& Infos);
+
+	/**
+	 * Sets the default value of each scalar parameter in Infos to the value at the same index. Parameters of another
+	 * type and values that are already set are skipped. Every expression is modified once and each affected
+	 * material is recompiled once, as a single undo step.
+	 * @return The number of expressions that changed.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Defaults")
+	static int32 SetMaterialParameterScalarDefaults(UPARAM(ref) TArray<FRedMaterialParameterInfo>& Infos,
+	                                                const TArray<float>& Values);
+
+	/** Vector version of SetMaterialParameterScalarDefaults. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Defaults")
+	static int32 SetMaterialParameterVectorDefaults(UPARAM(ref) TArray<FRedMaterialParameterInfo>& Infos,
+	                                                const TArray<FLinearColor>& Values);
+
+	/** Texture version of SetMaterialParameterScalarDefaults. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Defaults")
+	static int32 SetMaterialParameterTextureDefaults(UPARAM(ref) TArray<FRedMaterialParameterInfo>& Infos,
+	                                                 const TArray<UTexture*>& Values);
+
+	/** Static switch version of SetMaterialParameterScalarDefaults. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Defaults")
+	static int32 SetMaterialParameterStaticSwitchDefaults(UPARAM(ref) TArray<FRedMaterialParameterInfo>& Infos,
+	                                                      const TArray<bool>& Values);
+
+	/**
+	 * Finds every material and material function exposing a parameter with this name, using the asset registry.
+	 * No packages are loaded. Only assets saved with this plugin enabled are indexed, see GetUnindexedMaterialAssets.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Index")
+	static TArray<FRedIndexedMaterialParameter> FindIndexedMaterialParametersByName(FName ParameterName);
+
+	/** Finds every indexed parameter in the given group across all materials and material functions. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Index")
+	static TArray<FRedIndexedMaterialParameter> FindIndexedMaterialParametersByGroup(FName Group);
+
+	/** Gets the indexed parameters of a single material or material function without loading it. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Index")
+	static TArray<FRedIndexedMaterialParameter> GetIndexedMaterialParameters(const FSoftObjectPath& Asset);
+
+	/** Materials and material functions that have not been saved with the parameter tag yet. Resave them to index them. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Index")
+	static TArray<FSoftObjectPath> GetUnindexedMaterialAssets();
+
+	/**
+	 * Finds parameters with the same name but different types, groups or slider ranges across the materials and
+	 * material functions under PackagePaths (/Game if empty). Reads asset registry tags where they are up to date and
+	 * loads the remaining assets in batches if bLoadUntaggedAssets is set.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Index")
+	static FRedMaterialParameterConsistencyReport CheckMaterialParameterConsistency(
+		const TArray<FName>& PackagePaths, bool bLoadUntaggedAssets = true);
+
+	/** Writes a consistency report to a JSON file. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Index")
+	static bool ExportMaterialParameterConsistencyReport(const FRedMaterialParameterConsistencyReport& Report,
+	                                                     const FString& Filename);
+
+	/**
+	 * Searches the expressions of every material and material function without loading them, e.g.
+	 * "class:TextureSample texture:T_Rock_*" or "class:Custom -desc:approved". See FRedMaterialExpressionIndex for the
+	 * full query syntax. Only assets saved with this plugin enabled are indexed.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Index")
+	static TArray<FRedIndexedMaterialExpression> FindMaterialExpressions(const FString& Query);
+
+	/** Loads the asset of a search result and returns the expression, or null if it no longer exists. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Index")
+	static UMaterialExpression* ResolveIndexedMaterialExpression(const FRedIndexedMaterialExpression& Expression);
+
+	/**
+	 * Finds the materials and material functions reading each parameter of a collection, and the parameters nothing
+	 * reads. Uses the expression index, referencing assets that aren't indexed yet are loaded if bLoadUnindexedAssets
+	 * is set and reported as unknown readers otherwise.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Index")
+	static FRedCollectionUsageReport AnalyzeMaterialParameterCollectionUsage(UMaterialParameterCollection* Collection,
+	                                                                         bool bLoadUnindexedAssets = true);
+
+	/**
+	 * Removes the parameters of a collection that no material or material function reads, as one undoable edit.
+	 * Nothing is removed if any referencing material couldn't be checked, or if other assets reference the collection.
+	 * @param bDryRun Only report what would be removed.
+	 * @param bSavePackage Save the collection after pruning.
+	 * @param bIgnoreOtherReferencers Prune even though other assets, e.g. Blueprints, reference the collection. They
+	 *                                may set parameters by name and break once those are removed.
+	 * @return The usage report from before pruning.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Index")
+	static FRedCollectionUsageReport PruneUnusedMaterialParameterCollectionParameters(
+		UMaterialParameterCollection* Collection, bool bDryRun = true, bool bSavePackage = true,
+		bool bIgnoreOtherReferencers = false);
+
+	/** Opens the material editor on a search result and focuses the expression. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Index")
+	static UPARAM(DisplayName="Success?")bool OpenIndexedMaterialExpression(
+		const FRedIndexedMaterialExpression& Expression);
+
+	/**
+	 * Writes the metadata of every parameter in the given materials and material functions to a file, streamed as it
+	 * is gathered. The format follows the extension: .csv, .json or .jsonl (JSON Lines).
+	 * @return False if the file couldn't be written.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Serialization")
+	static bool ExportMaterialParameters(const TArray<UObject*>& MaterialsOrFunctions, const FString& Filename,
+	                                     int32& OutNumParameters);
+
+	/**
+	 * Reads parameter metadata written by ExportMaterialParameters and applies it in a single material edit batch.
+	 * Only fields that differ from the current values are changed, columns left out of the file are not touched, and
+	 * reimporting an unchanged file modifies nothing. Parameters are matched by expression guid, then by name.
+	 * @return False if the file couldn't be read.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Serialization")
+	static bool ImportMaterialParameters(const FString& Filename, int32& OutNumModifiedParameters);
+
+	/**
+	 * Captures the metadata and default values of every parameter in a material or material function. Collection
+	 * parameters are left out, their values live in the collection.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Presets")
+	static FRedMaterialParameterPreset CaptureMaterialParameterPreset(UObject* MaterialOrFunction,
+	                                                                  bool bIncludeFunctions = true);
+
+	/**
+	 * Applies a preset to a material or material function in a single material edit batch, so it is one undo step and
+	 * one recompile. Entries are matched by expression guid, then by name, and skipped if the parameter type differs.
+	 * Parameters are never renamed, and only fields that differ from the current values are changed.
+	 * @return The number of modified parameter expressions.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Presets")
+	static int32 ApplyMaterialParameterPreset(UObject* MaterialOrFunction, const FRedMaterialParameterPreset& Preset,
+	                                          bool bIncludeFunctions = false);
+
+	/** @return False if the file couldn't be written. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Presets")
+	static bool SaveMaterialParameterPresetToJson(const FRedMaterialParameterPreset& Preset, const FString& Filename);
+
+	/** @return False if the file couldn't be read or isn't a preset. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Presets")
+	static bool LoadMaterialParameterPresetFromJson(const FString& Filename, FRedMaterialParameterPreset& OutPreset);
+
+	/**
+	 * Renames the parameter, along with every other node of its material or function with the same name, and every
+	 * material instance override of it, so instances stay connected. Instances are found with the asset registry,
+	 * for a parameter in a material function that is every instance of every material using the function and every
+	 * instance whose own layer stack uses it, and are loaded in batches.
+	 * Nothing is renamed if the owner, a function it uses or, for a function, a material using it already has a
+	 * parameter named NewName.
+	 * The rename of the parameter itself can be undone, the instance overrides can't.
+	 * @param NumFailedSaves Set to the number of packages that failed to save, they are left loaded and dirty.
+	 * @param bSavePackages Save the parameter's material or function and each instance that changed, and release the
+	 *                      instances between batches. Otherwise the changed instances are left loaded and dirty.
+	 * @return The number of material instances whose overrides were renamed.
+	 */
+	UFUNCTION(BlueprintCallable, Category=MaterialExpressions)
+	static int32 RenameMaterialParameterInHierarchy(UPARAM(ref) FRedMaterialParameterInfo& Info, FName NewName,
+	                                                int32& NumFailedSaves, bool bSavePackages = true);
+
+	/**
+	 * Removes material instance overrides, static switches and component masks included, that have the same value the
+	 * instance would inherit from its parent. Looks at the root itself if it is an instance and at every instance below
+	 * it, found with the asset registry and loaded in batches.
+	 * @param bDryRun Only report what would be removed.
+	 * @param bSavePackages Save each changed instance and release the instances between batches. The report's
+	 *                      package bytes are only measured when saving.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Instances")
+	static FRedMaterialOverridePruneReport PruneRedundantMaterialInstanceOverrides(
+		UMaterialInterface* Root, bool bDryRun = true, bool bSavePackages = true);
+
+	/**
+	 * Counts the static switch and component mask combinations used by the instances of a material, estimates the
+	 * shader maps and compile time they cost, and ranks the static parameters by how many permutations they add.
+	 * @param SecondsPerShaderMap Average compile time of one of this material's shader maps, for the estimate.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Instances")
+	static FRedMaterialPermutationReport AnalyzeStaticPermutations(UMaterialInterface* Material,
+	                                                                float SecondsPerShaderMap = 30.0f);
+
+	/** Writes a permutation report to a JSON file. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Instances")
+	static bool ExportStaticPermutationReport(const FRedMaterialPermutationReport& Report, const FString& Filename);
+
+	/**
+	 * Estimates the resident texture memory of the materials' default textures and, if bIncludeInstances is set, of
+	 * every instance below them with its overrides applied. Texture sizes come from asset registry tags, so textures
+	 * are never loaded. The report also lists textures imported more than once from the same source file.
+	 * @param bLoadUntaggedAssets Load materials and instances saved before they were tagged, instead of skipping them.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Instances")
+	static FRedTextureMemoryReport AnalyzeMaterialTextureMemory(const TArray<FSoftObjectPath>& Materials,
+	                                                            bool bIncludeInstances = true,
+	                                                            bool bLoadUntaggedAssets = false);
+
+	/** Writes a texture memory report to a JSON file. */
+	UFUNCTION(BlueprintCallable, Category="MaterialExpressions|Instances")
+	static bool ExportTextureMemoryReport(const FRedTextureMemoryReport& Report, const FString& Filename);
 };
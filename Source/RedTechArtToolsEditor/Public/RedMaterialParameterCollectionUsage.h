@@ -0,0 +1,115 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RedMaterialParameterCollectionUsage.generated.h"
+
+class UMaterialParameterCollection;
+
+/** The materials and material functions reading one parameter of a collection. */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedCollectionParameterUsage
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterCollectionUsage)
+	FName ParameterName = NAME_None;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterCollectionUsage)
+	bool bIsVector = false;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterCollectionUsage)
+	TArray<FSoftObjectPath> Readers;
+};
+
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedCollectionUsageReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterCollectionUsage)
+	FSoftObjectPath Collection;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterCollectionUsage)
+	TArray<FRedCollectionParameterUsage> Parameters;
+
+	/** Parameters no material or material function reads. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterCollectionUsage)
+	TArray<FName> UnusedParameters;
+
+	/**
+	 * Materials and functions referencing the collection that are neither indexed nor loaded, or whose index names a
+	 * parameter the collection no longer has because it was renamed since they were saved, so their reads are
+	 * unknown. Unused parameters can't be pruned while there are any.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterCollectionUsage)
+	TArray<FSoftObjectPath> UnknownReaders;
+
+	/**
+	 * Other assets referencing the collection, e.g. Blueprints setting its values. They don't affect what is unused,
+	 * but pruning is refused while there are any unless explicitly allowed.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterCollectionUsage)
+	TArray<FSoftObjectPath> OtherReferencers;
+
+	/** Materials and functions that had to be loaded because they weren't indexed. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterCollectionUsage)
+	int32 NumAssetsLoaded = 0;
+
+	/** Size of the collection's uniform buffer, and its size once the unused parameters are removed. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterCollectionUsage)
+	int32 UniformBufferBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterCollectionUsage)
+	int32 PrunedUniformBufferBytes = 0;
+};
+
+/**
+ * Finds which parameters of a material parameter collection are read by materials, using the expression index and
+ * the asset registry's references, and removes the ones nothing reads.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedMaterialParameterCollectionUsage
+{
+public:
+	/**
+	 * Maps each parameter of the collection to the materials and material functions reading it. Referencing assets
+	 * that aren't in the expression index, or whose index is out of date, are loaded in batches if
+	 * bLoadUnindexedAssets is set.
+	 */
+	static FRedCollectionUsageReport Analyze(const UMaterialParameterCollection* Collection,
+	                                         bool bLoadUnindexedAssets);
+
+	/**
+	 * Removes the report's unused parameters from the collection in one undoable transaction. Refuses if the report
+	 * has unknown readers, or if it is for a different collection.
+	 * @param bIgnoreOtherReferencers Prune even though other assets, e.g. Blueprints, reference the collection and
+	 *                                may set the parameters being removed. Refused otherwise.
+	 * @return The number of parameters removed, or INDEX_NONE if nothing was done.
+	 */
+	static int32 PruneUnusedParameters(UMaterialParameterCollection* Collection,
+	                                   const FRedCollectionUsageReport& Report, bool bIgnoreOtherReferencers = false);
+
+	/** Uniform buffer size of a collection with this many parameters, scalars are packed four to a vector. */
+	static int32 GetUniformBufferBytes(int32 NumScalarParameters, int32 NumVectorParameters);
+};
@@ -0,0 +1,109 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RedMaterialParameterConsistency.generated.h"
+
+struct FAssetData;
+
+/** One way a parameter is declared, and the assets that declare it that way. */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedMaterialParameterSignature
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterConsistency)
+	FName TypeName = NAME_None;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterConsistency)
+	FName Group = NAME_None;
+
+	/** Slider range, only compared for scalar parameters. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterConsistency)
+	float ScalarMin = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterConsistency)
+	float ScalarMax = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterConsistency)
+	TArray<FSoftObjectPath> Assets;
+};
+
+/** A parameter name that is declared differently in different materials or functions. */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedMaterialParameterConflict
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterConsistency)
+	FName ParameterName = NAME_None;
+
+	/** Which parts of the declaration differ: Type, Group and/or SliderRange. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterConsistency)
+	TArray<FName> ConflictingFields;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterConsistency)
+	TArray<FRedMaterialParameterSignature> Signatures;
+};
+
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedMaterialParameterConsistencyReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterConsistency)
+	int32 NumAssetsChecked = 0;
+
+	/** Assets that had to be loaded because their asset registry tag was missing or out of date. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterConsistency)
+	int32 NumAssetsLoaded = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterConsistency)
+	int32 NumParametersChecked = 0;
+
+	/** Conflicts sorted by parameter name. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterConsistency)
+	TArray<FRedMaterialParameterConflict> Conflicts;
+};
+
+/**
+ * Finds parameters that share a name but not a type, group or slider range across materials and material functions.
+ * Parameters are read from the asset registry tags written by FRedMaterialParameterIndex, only assets without an up
+ * to date tag are loaded. Parameter collection nodes are not checked, their names belong to the collection.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedMaterialParameterConsistency
+{
+public:
+	/**
+	 * @param PackagePaths Content paths to check recursively, /Game if empty.
+	 * @param bLoadUntaggedAssets Load assets without an up to date tag in batches, otherwise they are skipped.
+	 */
+	static FRedMaterialParameterConsistencyReport Check(const TArray<FName>& PackagePaths, bool bLoadUntaggedAssets);
+
+	/** Checks only the given materials and material functions. */
+	static FRedMaterialParameterConsistencyReport Check(TConstArrayView<FAssetData> Assets, bool bLoadUntaggedAssets);
+
+	/** Writes the report to a JSON file, returns false if it couldn't be written. */
+	static bool ExportReport(const FRedMaterialParameterConsistencyReport& Report, const FString& Filename);
+};
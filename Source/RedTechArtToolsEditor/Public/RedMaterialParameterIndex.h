@@ -0,0 +1,133 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "RedMaterialParameterIndex.generated.h"
+
+/** One parameter exposed by a material or material function, as recorded in its asset registry tags. */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedIndexedMaterialParameter
+{
+	GENERATED_BODY()
+
+	/** The material or material function that exposes the parameter. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterIndex)
+	FSoftObjectPath Asset;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterIndex)
+	FName ParameterName = NAME_None;
+
+	/** Same names as URedMaterialParameterBlueprintLibrary::GetMaterialParameter_TypeName, or CollectionParameter. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterIndex)
+	FName TypeName = NAME_None;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterIndex)
+	FName Group = NAME_None;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterIndex)
+	FGuid ExpressionGuid;
+
+	/** The material function the parameter expression lives in, or empty if it is directly in Asset. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterIndex)
+	FSoftObjectPath OwningFunction;
+
+	/** Slider range of scalar parameters, only valid if bHasScalarRange. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterIndex)
+	float ScalarMin = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterIndex)
+	float ScalarMax = 0.0f;
+
+	/** False for assets last saved before the slider range was recorded in the tag. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialParameterIndex)
+	bool bHasScalarRange = false;
+};
+
+/**
+ * Project wide index of material parameters that never loads a package.
+ *
+ * When a material or material function is saved its parameters are written into a hidden asset registry tag. The
+ * index is built from those tags and kept up to date from asset registry add, update, rename and remove events.
+ * Assets saved before the tag existed are listed by GetUnindexedAssets, resaving them adds them to the index.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedMaterialParameterIndex
+{
+public:
+	/** Name of the asset registry tag parameters are stored in. */
+	static const FName ParametersTagName;
+
+	static FRedMaterialParameterIndex& Get();
+
+	/** Starts writing the parameter tag for saved materials. Called on module startup. */
+	static void RegisterTagWriter();
+
+	/** Stops writing tags and releases the index. Called on module shutdown. */
+	static void Shutdown();
+
+	~FRedMaterialParameterIndex();
+
+	/** Every indexed parameter with the given name, across all materials and material functions. */
+	TArray<FRedIndexedMaterialParameter> FindByName(FName ParameterName);
+
+	/** Every indexed parameter in the given group. */
+	TArray<FRedIndexedMaterialParameter> FindByGroup(FName Group);
+
+	/** Every parameter the given material or function exposes. */
+	TArray<FRedIndexedMaterialParameter> GetParameters(const FSoftObjectPath& Asset);
+
+	/** Materials and functions that have no parameter tag yet, they need to be resaved to be indexed. */
+	TArray<FSoftObjectPath> GetUnindexedAssets();
+
+	/** Writes the parameter tag value for a material or function. Exposed for tools that want the same format. */
+	static FString MakeParametersTagValue(const UObject* MaterialOrFunction);
+
+	/** Parses a parameter tag value back into parameters, returns false if the value is malformed. */
+	static bool ParseParametersTagValue(const FSoftObjectPath& Asset, FStringView TagValue,
+	                                    TArray<FRedIndexedMaterialParameter>& OutParameters);
+
+	/** Is this asset a material or material function, the assets the index knows about. */
+	static bool IsIndexedAssetClass(const FAssetData& AssetData);
+
+private:
+	void BuildIndex();
+	void AddAsset(const FAssetData& AssetData);
+	void RemoveAsset(const FSoftObjectPath& Asset);
+
+	void HandleAssetAddedOrUpdated(const FAssetData& AssetData);
+	void HandleAssetRemoved(const FAssetData& AssetData);
+	void HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+	void HandleFilesLoaded();
+
+	bool bIsBuilt = false;
+	TMap<FSoftObjectPath, TArray<FRedIndexedMaterialParameter>> ParametersByAsset;
+	TMap<FName, TSet<FSoftObjectPath>> AssetsByParameterName;
+	TSet<FSoftObjectPath> UnindexedAssets;
+
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetUpdatedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle FilesLoadedHandle;
+};
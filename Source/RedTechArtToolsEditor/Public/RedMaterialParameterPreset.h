@@ -0,0 +1,133 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RedParameterChannelNamesWrapper.h"
+#include "Engine/DataAsset.h"
+#include "RedMaterialParameterPreset.generated.h"
+
+class UCurveLinearColor;
+class UCurveLinearColorAtlas;
+class UTexture;
+
+/** One parameter's metadata and default value, as captured in a preset. */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedMaterialParameterPresetEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	FName ParameterName = NAME_None;
+
+	/** Matched first when applying, so the preset finds parameters in the material it was captured from. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	FGuid ExpressionGuid;
+
+	/** Same names as URedMaterialParameterBlueprintLibrary::GetMaterialParameter_TypeName. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	FName TypeName = NAME_None;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	FName Group = NAME_None;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	int32 SortPriority = 0;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	FString Description;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	float ScalarMin = 0.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	float ScalarMax = 0.0f;
+
+	/** Vector and texture parameters only. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	FRedParameterChannelNamesWrapper ChannelNames;
+
+	/** Curve atlas row parameters only. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	TSoftObjectPtr<UCurveLinearColor> ScalarCurve;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	TSoftObjectPtr<UCurveLinearColorAtlas> ScalarAtlas;
+
+	/** Only the value matching TypeName is used. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	float ScalarValue = 0.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	FLinearColor VectorValue = FLinearColor::Black;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	FVector4 DoubleVectorValue = FVector4(0.0, 0.0, 0.0, 0.0);
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	TSoftObjectPtr<UTexture> TextureValue;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	bool bStaticSwitchValue = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	bool bStaticComponentMaskR = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	bool bStaticComponentMaskG = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	bool bStaticComponentMaskB = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	bool bStaticComponentMaskA = false;
+};
+
+/**
+ * The parameter metadata and default values of a material or material function, to roll it back later or apply to
+ * other materials. Captured and applied with URedMaterialParameterBlueprintLibrary, stored in a
+ * URedMaterialParameterPresetAsset or as JSON.
+ */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedMaterialParameterPreset
+{
+	GENERATED_BODY()
+
+	/** The material or material function the preset was captured from. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	FSoftObjectPath Source;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	TArray<FRedMaterialParameterPresetEntry> Parameters;
+};
+
+/** A material parameter preset saved as an asset. */
+UCLASS(BlueprintType)
+class REDTECHARTTOOLSEDITOR_API URedMaterialParameterPresetAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category=MaterialParameterPreset)
+	FRedMaterialParameterPreset Preset;
+};
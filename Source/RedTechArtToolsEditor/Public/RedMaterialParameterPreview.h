@@ -0,0 +1,95 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "MaterialTypes.h"
+
+class UMaterial;
+class UMaterialExpression;
+
+/**
+ * Live preview of material parameter edits, for sliders and other interactions that set a value many times a second.
+ *
+ * While a preview is active, FRedMaterialEditBatch::ModifyExpression records the expression's original state instead
+ * of modifying it, so the setters write straight to the expressions without transactions or recompiles. Once per
+ * frame the latest numeric default values are pushed to the materials using the expressions as preview overrides,
+ * however many times they were set during the frame. Ending the preview either commits every change as one undoable
+ * edit with a single recompile per material, or puts the original values back.
+ *
+ *	FRedMaterialParameterPreview::Begin(LOCTEXT("ScrubRoughness", "Scrub Roughness"));
+ *	... call setters as the slider moves ...
+ *	FRedMaterialParameterPreview::End(true);
+ */
+class REDTECHARTTOOLSEDITOR_API FRedMaterialParameterPreview
+{
+public:
+	/** Starts a preview, ending any active one without committing it. */
+	static void Begin(const FText& Description);
+
+	/**
+	 * Ends the active preview.
+	 * @param bCommit Apply the previewed values as one transaction, otherwise restore the original values.
+	 * @return The number of expressions that were changed, or 0 if nothing was committed.
+	 */
+	static int32 End(bool bCommit);
+
+	/** The preview edits are being recorded into, or nullptr if there isn't one. */
+	static FRedMaterialParameterPreview* GetActive();
+
+	/** Called instead of modifying the expression while a preview is active. */
+	void RecordExpression(UMaterialExpression* Expression);
+
+	explicit FRedMaterialParameterPreview(const FText& InDescription);
+	~FRedMaterialParameterPreview();
+
+	FRedMaterialParameterPreview(const FRedMaterialParameterPreview&) = delete;
+	FRedMaterialParameterPreview& operator=(const FRedMaterialParameterPreview&) = delete;
+
+private:
+	/** A loaded material the expression is in, directly or through a function, possibly as several layers. */
+	struct FMaterialUse
+	{
+		TWeakObjectPtr<UMaterial> Material;
+		TArray<FMaterialParameterInfo> ParameterInfos;
+	};
+
+	struct FRecord
+	{
+		TWeakObjectPtr<UMaterialExpression> Expression;
+		TArray<uint8> OriginalState;
+		TArray<FMaterialUse> Materials;
+		bool bNeedsUpdate = true;
+	};
+
+	bool Tick(float DeltaTime);
+	void UpdatePreviewValues();
+	void ClearPreviewValues();
+	int32 Finish(bool bCommit);
+
+	FText Description;
+	TArray<FRecord> Records;
+	TMap<TWeakObjectPtr<UMaterialExpression>, int32> RecordIndices;
+	FTSTicker::FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,109 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RedMaterialPermutationAnalysis.generated.h"
+
+class UMaterialInterface;
+
+/** How much one static parameter adds to a material's permutations. */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedStaticParameterCost
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialPermutations)
+	FName ParameterName = NAME_None;
+
+	/** StaticSwitch or StaticComponentMask. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialPermutations)
+	FName TypeName = NAME_None;
+
+	/** Layer index for layer parameters, INDEX_NONE for global ones. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialPermutations)
+	int32 LayerIndex = INDEX_NONE;
+
+	/** Instances that set the parameter themselves rather than inheriting it. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialPermutations)
+	int32 NumOverridingInstances = 0;
+
+	/** Different values the parameter has across the used combinations. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialPermutations)
+	int32 NumDistinctValues = 0;
+
+	/** How many fewer combinations there would be if this parameter were always left at one value. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialPermutations)
+	int32 NumPermutationsContributed = 0;
+};
+
+/** The static permutations a material's instance tree actually uses. */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedMaterialPermutationReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialPermutations)
+	FSoftObjectPath Material;
+
+	UPROPERTY(BlueprintReadOnly, Category=MaterialPermutations)
+	int32 NumInstances = 0;
+
+	/** Instances that compile their own shaders because of static parameter or base property overrides. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialPermutations)
+	int32 NumInstancesWithStaticPermutation = 0;
+
+	/** Distinct combinations of static parameter values and base property overrides, the material's own included. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialPermutations)
+	int32 NumDistinctCombinations = 0;
+
+	/**
+	 * Shader maps compiled per platform and quality level. Instances with identical combinations share a shader map,
+	 * so this is the number of distinct combinations.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialPermutations)
+	int32 EstimatedShaderMaps = 0;
+
+	/** EstimatedShaderMaps times the seconds per shader map the analysis was given. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialPermutations)
+	float EstimatedCompileSeconds = 0.0f;
+
+	/** Static parameters, the ones contributing the most permutations first. */
+	UPROPERTY(BlueprintReadOnly, Category=MaterialPermutations)
+	TArray<FRedStaticParameterCost> Parameters;
+};
+
+/** Counts the static parameter combinations used under a material, to see which switches cost the most shaders. */
+class REDTECHARTTOOLSEDITOR_API FRedMaterialPermutationAnalysis
+{
+public:
+	/**
+	 * Analyzes every material instance below the material's base material. Instances are found with the asset
+	 * registry and loaded in batches.
+	 * @param SecondsPerShaderMap Average time to compile one shader map of this material, for the compile estimate.
+	 */
+	static FRedMaterialPermutationReport Analyze(UMaterialInterface* Material, float SecondsPerShaderMap);
+
+	/** Writes the report to a JSON file, returns false if it couldn't be written. */
+	static bool ExportReport(const FRedMaterialPermutationReport& Report, const FString& Filename);
+};
@@ -0,0 +1,188 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RedMaterialTextureMemory.generated.h"
+
+/** Size of one texture, read from its asset registry tags, and the memory it takes once resident. */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedTextureMemoryInfo
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	FSoftObjectPath Texture;
+
+	/** False if the texture has no size tags, e.g. it is missing or was never saved. Its memory is left at zero. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	bool bHasSizeTags = false;
+
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	int32 Width = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	int32 Height = 0;
+
+	/** Pixel format, e.g. DXT1 or BC7. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	FName Format = NAME_None;
+
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	FName LODGroup = NAME_None;
+
+	/** Size of the top mip after the LOD group's bias and maximum size are applied. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	int32 ResidentWidth = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	int32 ResidentHeight = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	int32 NumResidentMips = 0;
+
+	/** Estimated memory of the resident mips, assuming a full mip chain. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	int64 ResidentBytes = 0;
+
+	/** MD5 of the file the texture was imported from, if the import data recorded it. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	FString SourceFileHash;
+};
+
+/** A texture a material or instance uses. */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedMaterialTextureUse
+{
+	GENERATED_BODY()
+
+	/** The texture parameter, or None for a texture sampled directly. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	FName ParameterName = NAME_None;
+
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	FSoftObjectPath Texture;
+
+	/** Set if the instance overrides the parameter rather than inheriting it. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	bool bIsOverride = false;
+};
+
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedMaterialTextureMemoryEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	FSoftObjectPath Asset;
+
+	/** The parent of an instance, unset for materials. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	FSoftObjectPath Parent;
+
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	TArray<FRedMaterialTextureUse> Textures;
+
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	int32 NumUniqueTextures = 0;
+
+	/** Resident memory of the distinct textures the asset uses. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	int64 ResidentBytes = 0;
+};
+
+/** Different texture assets imported from identical source files. */
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedDuplicatedTextures
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	FString SourceFileHash;
+
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	TArray<FSoftObjectPath> Textures;
+
+	/** Memory that would be saved by keeping only the largest of the textures. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	int64 DuplicatedBytes = 0;
+};
+
+USTRUCT(BlueprintType)
+struct REDTECHARTTOOLSEDITOR_API FRedTextureMemoryReport
+{
+	GENERATED_BODY()
+
+	/** The materials, then their instances with every instance after its parent. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	TArray<FRedMaterialTextureMemoryEntry> Materials;
+
+	/** Every texture used, largest first. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	TArray<FRedTextureMemoryInfo> Textures;
+
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	TArray<FRedDuplicatedTextures> Duplicates;
+
+	/** Device profile whose texture LOD settings were used. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	FString DeviceProfile;
+
+	/** Assets that had to be loaded because they weren't indexed or tagged. */
+	UPROPERTY(BlueprintReadOnly, Category=TextureMemory)
+	int32 NumAssetsLoaded = 0;
+};
+
+/**
+ * Estimates the texture memory materials pull in through their default textures, and their instances through their
+ * overrides, without loading textures.
+ *
+ * Default textures are every texture the expression index records as referenced, including the ones in material
+ * functions, and instance overrides come from a hidden asset registry tag written when instances are saved. Assets
+ * without these tags can be loaded instead, they are then read with the same code that writes the tags, so the result
+ * is the same as if they had been saved. Texture sizes and formats always come from the textures' own asset registry
+ * tags.
+ */
+class REDTECHARTTOOLSEDITOR_API FRedMaterialTextureMemory
+{
+public:
+	static const FName TextureOverridesTagName;
+
+	/** Starts writing the texture override tag for saved material instances. Called on module startup. */
+	static void RegisterTagWriter();
+
+	/** Called on module shutdown. */
+	static void Shutdown();
+
+	/**
+	 * Builds the report for the given materials and, if bIncludeInstances is set, every instance below them.
+	 * Assets without the tags are skipped unless bLoadUntaggedAssets is set.
+	 */
+	static FRedTextureMemoryReport Analyze(TConstArrayView<FSoftObjectPath> Materials, bool bIncludeInstances,
+	                                       bool bLoadUntaggedAssets);
+
+	/** Writes a texture memory report to a JSON file. */
+	static bool ExportReport(const FRedTextureMemoryReport& Report, const FString& Filename);
+
+	static FString MakeTextureOverridesTagValue(const UObject* MaterialInstance);
+};
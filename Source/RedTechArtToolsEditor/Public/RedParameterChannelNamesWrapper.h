@@ -0,0 +1,66 @@
+// MIT License
+//
+// Copyright (c) 2022 Ryan DowlingSoka
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MaterialTypes.h"
+#include "RedParameterChannelNamesWrapper.generated.h"
+
+USTRUCT(BlueprintType)
+struct FRedParameterChannelNamesWrapper
+{
+	GENERATED_USTRUCT_BODY()
+
+	FRedParameterChannelNamesWrapper() = default;
+
+	FRedParameterChannelNamesWrapper(const FText& InR, const FText& InG, const FText& InB,
+	                                 const FText& InA) : R(InR), G(InG), B(InB), A(InA)
+	{
+	}
+
+	FRedParameterChannelNamesWrapper(const FParameterChannelNames& ChannelNames)
+	{
+		R = ChannelNames.R;
+		G = ChannelNames.G;
+		B = ChannelNames.B;
+		A = ChannelNames.A;
+	}
+
+	FParameterChannelNames ToParameterChannelNames() const
+	{
+		return FParameterChannelNames(R, G, B, A);
+	}
+
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = MaterialExpressionVectorParameter)
+	FText R;
+
+	UPROPERTY(BlueprintReadWrite, Category = MaterialExpressionVectorParameter)
+	FText G;
+
+	UPROPERTY(BlueprintReadWrite, Category = MaterialExpressionVectorParameter)
+	FText B;
+
+	UPROPERTY(BlueprintReadWrite, Category = MaterialExpressionVectorParameter)
+	FText A;
+};
@@ -25,6 +25,9 @@
 #include "CoreMinimal.h"
 #include "BlueprintEditorLibrary.h"
 #include "Blueprint/UserWidget.h"
+#include "RedDataTableDiff.h"
+#include "RedDataTableExport.h"
+#include "RedDataTableImport.h"
 #include "RedTechArtToolsBlueprintLibrary.generated.h"
 
 class UDataTable;
@@ -105,16 +108,54 @@ public:
 	static FString GetTableAsString(const UDataTable* DataTable, bool bUseJsonObjectsForStructs = false,
 	                                bool bUseSimpleText = false);
 
-	/** Output entire contents of DataTable as CSV */
+	/** Output entire contents of DataTable as CSV, in the layout the DataTable CSV importer reads */
 	UFUNCTION(BlueprintCallable, Category=DataTable)
 	static FString GetTableAsCSV(const UDataTable* DataTable, bool bUseJsonObjectsForStructs = false,
 	                             bool bUseSimpleText = false);
 
-	/** Output entire contents of DataTable as JSON */
+	/** Output entire contents of DataTable as JSON, an array of row objects with the row name in "Name" */
 	UFUNCTION(BlueprintCallable, Category=DataTable)
 	static FString GetTableAsJSON(const UDataTable* DataTable, bool bUseJsonObjectsForStructs = false,
 	                              bool bUseSimpleText = false);
 
+	/**
+	 * Writes the rows of a DataTable to a CSV or JSON file, picked by the extension. Rows are streamed to the file a
+	 * chunk at a time, so memory use doesn't grow with the table. Options select a row range and a subset of columns.
+	 * @return False if the file couldn't be written.
+	 */
+	UFUNCTION(BlueprintCallable, Category=DataTable)
+	static bool ExportTableToFile(const UDataTable* DataTable, const FString& Filename,
+	                              const FRedDataTableExportOptions& Options, FRedDataTableExportStats& OutStats);
+
+	/**
+	 * Imports a CSV or JSON file written by ExportTableToFile, or in the layout the DataTable importers read, by only
+	 * adding, updating and removing the rows that differ. All changes are one undo step with a single refresh of
+	 * anything using the table, and reimporting an unchanged file touches nothing.
+	 * @return False if the file couldn't be read.
+	 */
+	UFUNCTION(BlueprintCallable, Category=DataTable)
+	static bool ImportTableFromFile(UDataTable* DataTable, const FString& Filename,
+	                                const FRedDataTableImportOptions& Options, FRedDataTableImportStats& OutStats);
+
+	/** Rows added, changed or removed going from Old to New, with the changed columns of each changed row. */
+	UFUNCTION(BlueprintCallable, Category=DataTable)
+	static TArray<FRedDataTableRowDiff> DiffTables(const UDataTable* Old, const UDataTable* New);
+
+	/**
+	 * Rows added, changed or removed since a snapshot written by ExportTableToFile, for example from an earlier
+	 * revision of the table.
+	 * @param ExportOptions The options the snapshot was written with.
+	 * @return False if the snapshot couldn't be read.
+	 */
+	UFUNCTION(BlueprintCallable, Category=DataTable)
+	static bool DiffTableWithSnapshot(const UDataTable* DataTable, const FString& SnapshotFilename,
+	                                  const FRedDataTableExportOptions& ExportOptions,
+	                                  TArray<FRedDataTableRowDiff>& OutDiffs);
+
+	/** Writes row diffs to a CSV or JSON file, picked by the extension. */
+	UFUNCTION(BlueprintCallable, Category=DataTable)
+	static bool ExportTableDiffs(const TArray<FRedDataTableRowDiff>& Diffs, const FString& Filename);
+
 	/** Is A less than or equal to B alphanumerically. */
 	UFUNCTION(BlueprintCallable, Category=String)
 	static bool AlphaNumericLessThan(UPARAM(ref) const FString& A, UPARAM(ref) const FString& B);
@@ -30,17 +30,21 @@ public class RedTechArtToolsEditor : ModuleRules
 
 		PrivateDependencyModuleNames.AddRange(new string[]
 		{
+			"AssetRegistry",
 			"BlueprintEditorLibrary",
 			"BlueprintGraph",
 			"Blutility",
 			"Core",
 			"CoreUObject",
 			"DeveloperSettings",
+			"DirectoryWatcher",
 			"EditorFramework",
 			"EditorScriptingUtilities",
 			"EditorStyle",
 			"Engine",
 			"InputCore",
+			"Json",
+			"JsonUtilities",
 			"Kismet",
 			"KismetCompiler",
 			"MainFrame",